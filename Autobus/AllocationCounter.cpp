@@ -0,0 +1,42 @@
+#include "AllocationCounter.h"
+
+#ifdef AUTOBUS_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<long long> allocationCount(0);
+
+// Zamena je u posebnom fajlu da se ne bi ugradjivala (inline) u kod koji zauzima memoriju
+void* operator new(size_t size) {
+    allocationCount++;
+    void* memory = malloc(size != 0 ? size : 1);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+long long getAllocationCount() {
+    return allocationCount;
+}
+
+bool isCountingAllocations() {
+    return true;
+}
+#else
+long long getAllocationCount() {
+    return 0;
+}
+
+bool isCountingAllocations() {
+    return false;
+}
+#endif
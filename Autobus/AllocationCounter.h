@@ -0,0 +1,12 @@
+#pragma once
+
+// Brojac zauzimanja memorije (operator new) u celom programu, da bi merenja mogla da provere da
+// simulacija u toku rada ne zauzima memoriju. Brojanje zamenjuje globalni operator new, a zamena
+// vazi za ceo program, pa postoji samo ako je definisan AUTOBUS_COUNT_ALLOCATIONS (u projektu:
+// Bench konfiguracije). Bez njega je broj uvek 0, pa provere zauzimanja prolaze.
+
+// Broj zauzimanja od pokretanja programa
+long long getAllocationCount();
+
+// Da li se zauzimanja broje (izdanje sa AUTOBUS_COUNT_ALLOCATIONS)
+bool isCountingAllocations();
@@ -0,0 +1,170 @@
+#include "Atlas.h"
+#include "GlState.h"
+#include "stb_image.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+// Najmanja sirina atlasa koja se proba pri pakovanju
+const int ATLAS_MIN_WIDTH = 64;
+
+struct AtlasImage {
+    std::vector<unsigned char> pixels;   // RGBA, redovi odozdo nagore (kao u GL-u)
+    int width = 0;
+    int height = 0;
+};
+
+static bool loadAtlasImage(AtlasImage& image, const char* filePath) {
+    int channels;
+    unsigned char* data = stbi_load(filePath, &image.width, &image.height, &channels, 4);
+    if (data == NULL) {
+        std::cout << "Slika za atlas nije ucitana! Putanja slike: " << filePath << std::endl;
+        return false;
+    }
+    // Slike se ucitavaju naopako, pa se redovi okrecu pri kopiranju
+    size_t rowBytes = 4 * (size_t)image.width;
+    image.pixels.resize(rowBytes * image.height);
+    for (int row = 0; row < image.height; ++row)
+        memcpy(&image.pixels[rowBytes * (image.height - 1 - row)], data + rowBytes * row, rowBytes);
+    stbi_image_free(data);
+    return true;
+}
+
+// Smanjuje sliku na pola: piksel je prosek bloka 2x2, a boja je ponderisana providnoscu, da
+// providni pikseli (cija boja se ne vidi) ne zatamne ivice slike
+static void halveImage(AtlasImage& image) {
+    int width = std::max(image.width / 2, 1);
+    int height = std::max(image.height / 2, 1);
+    std::vector<unsigned char> pixels(4 * (size_t)width * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned int sum[4] = {};
+            for (int dy = 0; dy < 2; ++dy) {
+                for (int dx = 0; dx < 2; ++dx) {
+                    int sx = std::min(2 * x + dx, image.width - 1);
+                    int sy = std::min(2 * y + dy, image.height - 1);
+                    const unsigned char* p = &image.pixels[4 * ((size_t)sy * image.width + sx)];
+                    for (int c = 0; c < 3; ++c)
+                        sum[c] += p[c] * p[3];
+                    sum[3] += p[3];
+                }
+            }
+            unsigned char* out = &pixels[4 * ((size_t)y * width + x)];
+            for (int c = 0; c < 3; ++c)
+                out[c] = (unsigned char)(sum[3] > 0 ? (sum[c] + sum[3] / 2) / sum[3] : 0);
+            out[3] = (unsigned char)((sum[3] + 2) / 4);
+        }
+    }
+    image.pixels.swap(pixels);
+    image.width = width;
+    image.height = height;
+}
+
+// Pakovanje u police sirine width: slike (poredjane po visini, najvisa prva) idu sleva nadesno, a
+// nova polica pocinje iznad najvise slike prethodne. Vraca visinu atlasa, INT_MAX ako slika ne staje.
+static int packShelves(std::vector<AtlasRegion>& regions, const std::vector<int>& order, int width, int padding) {
+    int x = 0, y = 0, shelfHeight = 0;
+    for (int i : order) {
+        int w = regions[i].width + 2 * padding;
+        int h = regions[i].height + 2 * padding;
+        if (w > width)
+            return INT_MAX;
+        if (x + w > width) {
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+        regions[i].x = x + padding;
+        regions[i].y = y + padding;
+        x += w;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+    return y + shelfHeight;
+}
+
+bool buildTextureAtlas(TextureAtlas& atlas, const char* const* filePaths, int count, int padding, int maxImageSize) {
+    destroyTextureAtlas(atlas);
+    std::vector<AtlasImage> images(count);
+    atlas.regions.resize(count);
+    for (int i = 0; i < count; ++i) {
+        if (!loadAtlasImage(images[i], filePaths[i])) {
+            atlas.regions.clear();
+            return false;
+        }
+        while (images[i].width > maxImageSize || images[i].height > maxImageSize)
+            halveImage(images[i]);
+        atlas.regions[i].name = filePaths[i];
+        atlas.regions[i].width = images[i].width;
+        atlas.regions[i].height = images[i].height;
+    }
+
+    std::vector<int> order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+        [&](int a, int b) { return atlas.regions[a].height > atlas.regions[b].height; });
+
+    // Od sirina koje su stepen dvojke bira se ona sa najmanjom povrsinom atlasa
+    int maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    long long bestArea = LLONG_MAX;
+    for (int width = ATLAS_MIN_WIDTH; width <= maxTextureSize; width *= 2) {
+        int height = packShelves(atlas.regions, order, width, padding);
+        if (height <= maxTextureSize && (long long)width * height < bestArea) {
+            bestArea = (long long)width * height;
+            atlas.width = width;
+            atlas.height = height;
+        }
+    }
+    if (bestArea == LLONG_MAX) {
+        std::cout << "Slike ne staju u atlas od " << maxTextureSize << " piksela!" << std::endl;
+        atlas.regions.clear();
+        return false;
+    }
+    packShelves(atlas.regions, order, atlas.width, padding);
+
+    // Kopiranje slika sa okvirom koji ponavlja ivicne piksele
+    std::vector<unsigned char> pixels(4 * (size_t)atlas.width * atlas.height);
+    for (int i = 0; i < count; ++i) {
+        AtlasRegion& region = atlas.regions[i];
+        const AtlasImage& image = images[i];
+        for (int y = -padding; y < region.height + padding; ++y) {
+            int sy = std::min(std::max(y, 0), region.height - 1);
+            for (int x = -padding; x < region.width + padding; ++x) {
+                int sx = std::min(std::max(x, 0), region.width - 1);
+                memcpy(&pixels[4 * ((size_t)(region.y + y) * atlas.width + region.x + x)],
+                    &image.pixels[4 * ((size_t)sy * image.width + sx)], 4);
+            }
+        }
+        region.u0 = (float)region.x / atlas.width;
+        region.v0 = (float)region.y / atlas.height;
+        region.u1 = (float)(region.x + region.width) / atlas.width;
+        region.v1 = (float)(region.y + region.height) / atlas.height;
+    }
+
+    glGenTextures(1, &atlas.texture);
+    bindTexture2D(atlas.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, atlas.width, atlas.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    bindTexture2D(0);
+    return true;
+}
+
+void destroyTextureAtlas(TextureAtlas& atlas) {
+    if (atlas.texture != 0)
+        deleteTexture(atlas.texture);
+    atlas = TextureAtlas();
+}
+
+int findAtlasRegion(const TextureAtlas& atlas, const char* name) {
+    for (size_t i = 0; i < atlas.regions.size(); ++i) {
+        if (atlas.regions[i].name == name)
+            return (int)i;
+    }
+    return -1;
+}
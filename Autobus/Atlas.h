@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Sve slike scene u jednoj teksturi (atlasu), da se u frejmu ne menja tekstura izmedju crtanja.
+// Slike se pakuju pri pokretanju u police (redove) po visini, sa okvirom od padding piksela oko
+// svake slike. Okvir ponavlja ivicne piksele slike, pa linearno filtriranje na ivici regiona daje
+// isto sto i GL_CLAMP_TO_EDGE na posebnoj teksturi (susedna slika ne "curi" u region).
+//
+// Slika veca od maxImageSize se pre pakovanja smanjuje na pola (ponovljeno), jer se slike crtaju
+// u par stotina piksela, a najvece su vise hiljada piksela (atlas bi inace bio 8192 piksela sirok).
+
+struct AtlasRegion {
+    std::string name;           // Putanja slike
+    int x = 0, y = 0;           // Donji levi ugao slike u atlasu (pikseli, bez okvira)
+    int width = 0, height = 0;  // Velicina slike u atlasu (posle smanjivanja)
+    float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;   // Teksturne koordinate regiona
+};
+
+struct TextureAtlas {
+    unsigned int texture = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<AtlasRegion> regions;   // Istim redom kao putanje u buildTextureAtlas
+};
+
+// Ucitava slike i pakuje ih u atlas; vraca false ako neka slika ne moze da se ucita ili atlas ne
+// staje u najvecu velicinu teksture (GL_MAX_TEXTURE_SIZE)
+bool buildTextureAtlas(TextureAtlas& atlas, const char* const* filePaths, int count, int padding, int maxImageSize);
+void destroyTextureAtlas(TextureAtlas& atlas);
+
+// Broj regiona slike sa tom putanjom, -1 ako je atlas nema
+int findAtlasRegion(const TextureAtlas& atlas, const char* name);
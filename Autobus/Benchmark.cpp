@@ -0,0 +1,1026 @@
+#include "Benchmark.h"
+#include "BenchmarkReport.h"
+#include "AllocationCounter.h"
+#include "Simulation.h"
+#include "Fleet.h"
+#include "Interpolation.h"
+#include "TimingWheel.h"
+#include "EventScheduler.h"
+#include "Random.h"
+#include "Route.h"
+#include "StopQueues.h"
+#include "Passengers.h"
+#include "Inspectors.h"
+#include "Snapshot.h"
+#include "Logger.h"
+#include "Telemetry.h"
+#include "Metrics.h"
+#include "Options.h"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <thread>
+
+// Seme za sve ulazne podatke merenja, da bi rezultati bili uporedivi izmedju pokretanja
+const unsigned long long BENCH_SEED = 12345;
+
+// Otprilike koliko autobus-koraka izvrsavamo po velicini flote
+const double FLEET_BENCH_VEHICLE_TICKS = 2e8;
+// Ali bar toliko koraka da svaki autobus krene i stigne (najduze ceka STATION_WAIT_SECONDS, pa putuje
+// TRAVEL_TIME_SECONDS; sekunda vise je rezerva), da bi i najveca flota merila polaske i dolaske
+const int FLEET_BENCH_MIN_TICKS = (int)((STATION_WAIT_SECONDS + TRAVEL_TIME_SECONDS + 1.0f) / SIMULATION_STEP_SECONDS);
+const double INTERPOLATION_BENCH_BUSES = 2e8;
+const long long EVENT_BENCH_OPERATIONS = 20000000;
+
+// Putanja sa 100K tacaka (10 segmenata po 10K tacaka) i 100K autobusa na njoj
+const int PATH_BENCH_POINTS_PER_SEGMENT = 10000;
+const int PATH_BENCH_BUSES = 100000;
+const int PATH_BENCH_TICKS = 600;
+
+// Mreza u obliku resetke NETWORK_BENCH_SIDE x NETWORK_BENCH_SIDE stanica (milion, vidi makeGridNetwork)
+const int NETWORK_BENCH_SIDE = 1000;
+const int NETWORK_BENCH_BUSES = 100000;
+const int NETWORK_BENCH_TICKS = 600;
+
+// 10M putnika u isto vreme na mrezi 300 x 300 stanica sa 100K autobusa
+const int PASSENGER_BENCH_SIDE = 300;
+const int PASSENGER_BENCH_BUSES = 100000;
+const int PASSENGER_BENCH_CAPACITY = 10000000;
+const int PASSENGER_BENCH_TICKS = 1800;
+
+// Vrsni sat na mrezi od 10K stanica (100 x 100): 20K autobusa, 10 minuta simuliranog vremena
+const int BOARDING_BENCH_SIDE = 100;
+const int BOARDING_BENCH_BUSES = 20000;
+const int BOARDING_BENCH_CAPACITY = 4000000;
+const double BOARDING_BENCH_DEMAND = 0.5;
+const double BOARDING_BENCH_SECONDS = 600.0;
+const int BOARDING_BENCH_WAITING = 50;    // Putnika u redu svakog mesta na pocetku
+const int BOARDING_BENCH_ROUNDS = 40;     // Krugova samo redova: svi autobusi pune 50 mesta
+
+// Kontrole u 100K punih autobusa odjednom
+const int INSPECTION_BENCH_BUSES = 100000;
+const int INSPECTION_BENCH_ROUNDS = 20;
+
+// 10K kontrolora koji presedaju na mrezi od 10K stanica sa 20K autobusa, 10 minuta simuliranog vremena
+const int INSPECTOR_BENCH_SIDE = 100;
+const int INSPECTOR_BENCH_BUSES = 20000;
+const int INSPECTOR_BENCH_INSPECTORS = 10000;
+const int INSPECTOR_BENCH_CAPACITY = 2000000;
+const double INSPECTOR_BENCH_SECONDS = 600.0;
+
+// Snimak stanja sa 10M putnika (ista simulacija kao kod merenja putnika)
+const char* const SNAPSHOT_BENCH_FILE = "bench.snap";
+const int SNAPSHOT_BENCH_TICKS = 60;
+
+// Dnevnik: zapisa u petlji i zapisa u poredjenju sa tekstualnim ispisom koji se prazni posle svake linije
+const char* const LOGGER_BENCH_FILE = "bench.log";
+const char* const LOGGER_BENCH_TEXT_FILE = "bench.txt";
+const int LOGGER_BENCH_EVENTS = 10000000;
+const int LOGGER_BENCH_TEXT_EVENTS = 200000;
+
+// Upisa u histogram po merenju i vrednosti za proveru tacnosti percentila
+const int METRICS_BENCH_RECORDS = 50000000;
+const int METRICS_BENCH_VALUES = 1000000;
+
+// Skup merenja (--bench suite): velicine flote za korak, broj tacaka po segmentu za pravljenje
+// putanje; svaki uzorak koraka flote radi najmanje SUITE_SAMPLE_BUS_TICKS autobus-koraka (da sat
+// ne bi bio grublji od merenja), a velicina ukupno oko SUITE_BUS_TICKS
+const int SUITE_FLEET_SIZES[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+const int SUITE_MAX_BUSES = 10000000;
+const int SUITE_ROUTE_POINTS[] = { 5, 50, 500, 5000, 50000 };
+const double SUITE_BUS_TICKS = 1e8;
+const double SUITE_SAMPLE_BUS_TICKS = 20000.0;
+const double SUITE_ROUTE_POINTS_TOTAL = 5e6;
+const int SUITE_MIN_SAMPLES = 30;
+const int SUITE_MAX_SAMPLES = 1000;
+const char* const SUITE_DEFAULT_JSON = "benchmark.json";
+
+// Telemetrija cele flote na 10 Hz tokom jednog simuliranog dana (korak simulacije = razmak uzoraka)
+const char* const TELEMETRY_BENCH_FILE = "bench.telemetry";
+const int TELEMETRY_BENCH_BUSES = 1000;
+const double TELEMETRY_BENCH_SECONDS = 24.0 * 60.0 * 60.0;
+
+// Broj zauzimanja za ispis; u izdanju koje ih ne broji (vidi AllocationCounter.h) to se i kaze
+static std::string formatAllocations(long long allocations) {
+    return isCountingAllocations() ? std::to_string(allocations) : "ne broje se (izdanje bez AUTOBUS_COUNT_ALLOCATIONS)";
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Korak flote (stanje svih autobusa) i racunanje pozicija za 1K do 1M autobusa
+static int benchmarkFleet() {
+    Network network;
+    makeLoopNetwork(network, NUM_STATIONS, ROUTE_AXIS_A, ROUTE_AXIS_B);
+    RoutePath route;
+    buildRoutePath(route, network, CURVE_POINTS_PER_SEGMENT, WIGGLE_RANGE, BENCH_SEED);
+
+    const int sizes[] = { 1000, 16000, 128000, 1000000 };
+    for (int size : sizes) {
+        Fleet fleet;
+        initFleet(fleet, size, network, BENCH_SEED);
+        int ticks = std::max((int)(FLEET_BENCH_VEHICLE_TICKS / size), FLEET_BENCH_MIN_TICKS);
+
+        long long arrivals = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; ++t)
+            arrivals += tickFleet(fleet, SIMULATION_STEP_SECONDS, network);
+        double tickSeconds = secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; ++t)
+            updateFleetPositions(fleet, route);
+        double positionSeconds = secondsSince(start);
+
+        double vehicleTicks = (double)size * ticks;
+        double tickRate = vehicleTicks / (tickSeconds * 1000.0);
+        std::cout << "Flota " << size << " autobusa, " << ticks << " koraka: "
+            << tickRate << " autobus-koraka/ms (pozicije: "
+            << vehicleTicks / (positionSeconds * 1000.0) << " autobus-koraka/ms), "
+            << arrivals << " dolazaka"
+            << (tickRate >= 1e6 ? "" : "  [ispod cilja od 1M/ms]") << std::endl;
+    }
+    return 0;
+}
+
+// Skalarna, SSE i AVX2 interpolacija pozicija za 1K, 100K i 10M autobusa
+static int benchmarkInterpolation() {
+    Network network;
+    makeLoopNetwork(network, NUM_STATIONS, ROUTE_AXIS_A, ROUTE_AXIS_B);
+    std::cout << "Izabrana verzija: " << getInterpolationKernelName() << std::endl;
+
+    struct KernelInfo { const char* name; InterpolationKernel kernel; bool supported; };
+    const KernelInfo kernels[] = {
+        { "skalarna", interpolateSegmentsScalar, true },
+        { "SSE", interpolateSegmentsSse, cpuSupportsSse() },
+        { "AVX2", interpolateSegmentsAvx2, cpuSupportsAvx2() },
+    };
+
+    const int sizes[] = { 1000, 100000, 10000000 };
+    for (int size : sizes) {
+        std::vector<int> fromIdx(size), toIdx(size);
+        std::vector<float> time(size), outX(size), outY(size);
+        RandomStream stream = makeRandomStream(BENCH_SEED, STREAM_BUS, 0);
+        for (int i = 0; i < size; ++i) {
+            fromIdx[i] = randomInt(stream, network.numStops);
+            toIdx[i] = fromIdx[i] + 1 == network.numStops ? 0 : fromIdx[i] + 1;
+            time[i] = TRAVEL_TIME_SECONDS * randomFloat(stream);
+        }
+
+        int repeats = (int)(INTERPOLATION_BENCH_BUSES / size);
+        double scalarRate = 0.0;
+        for (const KernelInfo& info : kernels) {
+            if (!info.supported)
+                continue;
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < repeats; ++r) {
+                info.kernel(network.stopPositions.data(), fromIdx.data(), toIdx.data(), time.data(),
+                    1.0f / TRAVEL_TIME_SECONDS, outX.data(), outY.data(), size);
+            }
+            double rate = (double)size * repeats / (secondsSince(start) * 1e6);
+            if (scalarRate == 0.0)
+                scalarRate = rate;
+            std::cout << size << " autobusa, " << info.name << ": " << rate << " M autobusa/s ("
+                << rate / scalarRate << "x)" << std::endl;
+        }
+    }
+    return 0;
+}
+
+// Dogadjaj za poredjenje sa binarnim heap-om (std::priority_queue)
+struct HeapEvent {
+    unsigned long long tick;
+    unsigned long long payload;
+};
+
+struct LaterHeapEvent {
+    bool operator()(const HeapEvent& a, const HeapEvent& b) const {
+        return a.tick > b.tick;
+    }
+};
+
+// Posle isteka dogadjaj se odmah ponovo zakazuje (polazak -> dolazak -> polazak...), pa broj
+// zakazanih dogadjaja ostaje isti tokom celog merenja
+static unsigned long long nextTransitionTick(unsigned long long tick, unsigned long long payload) {
+    const unsigned long long travelTicks = (unsigned long long)(TRAVEL_TIME_SECONDS / EVENT_TICK_SECONDS);
+    const unsigned long long waitTicks = (unsigned long long)(STATION_WAIT_SECONDS / EVENT_TICK_SECONDS);
+    return tick + ((payload & 1) ? travelTicks : waitTicks);
+}
+
+struct WheelBenchContext {
+    TimingWheel* wheel;
+    long long expired;
+};
+
+static void rescheduleTransition(void* user, unsigned long long tick, unsigned long long payload) {
+    WheelBenchContext& context = *(WheelBenchContext*)user;
+    scheduleTimer(*context.wheel, nextTransitionTick(tick, payload), payload ^ 1);
+    context.expired++;
+}
+
+// Tocak tajmera naspram std::priority_queue za 10K, 1M i 10M zakazanih dogadjaja
+static int benchmarkEventQueues() {
+    const int sizes[] = { 10000, 1000000, 10000000 };
+    const unsigned long long cycleTicks = (unsigned long long)((TRAVEL_TIME_SECONDS + STATION_WAIT_SECONDS) / EVENT_TICK_SECONDS);
+
+    for (int size : sizes) {
+        // Pocetna vremena dogadjaja rasporedjena po jednom ciklusu autobusa
+        std::vector<HeapEvent> initial(size);
+        RandomStream stream = makeRandomStream(BENCH_SEED, STREAM_BUS, 0);
+        for (int i = 0; i < size; ++i) {
+            initial[i].tick = randomInt(stream, (int)cycleTicks);
+            initial[i].payload = ((unsigned long long)i << 1) | (i & 1);
+        }
+
+        double heapNs = 0.0;
+        {
+            std::priority_queue<HeapEvent, std::vector<HeapEvent>, LaterHeapEvent> heap(LaterHeapEvent(), initial);
+            auto start = std::chrono::steady_clock::now();
+            for (long long op = 0; op < EVENT_BENCH_OPERATIONS; ++op) {
+                HeapEvent event = heap.top();
+                heap.pop();
+                event.tick = nextTransitionTick(event.tick, event.payload);
+                event.payload ^= 1;
+                heap.push(event);
+            }
+            heapNs = secondsSince(start) * 1e9 / EVENT_BENCH_OPERATIONS;
+        }
+
+        double wheelNs = 0.0;
+        double cancelNs = 0.0;
+        {
+            TimingWheel* wheel = new TimingWheel();
+            initTimingWheel(*wheel, 0, size);
+            std::vector<long long> handles(size);
+            for (int i = 0; i < size; ++i)
+                handles[i] = scheduleTimer(*wheel, initial[i].tick, initial[i].payload);
+
+            WheelBenchContext context = { wheel, 0 };
+            auto start = std::chrono::steady_clock::now();
+            unsigned long long tick = 0;
+            while (context.expired < EVENT_BENCH_OPERATIONS)
+                advanceTimingWheel(*wheel, tick++, rescheduleTransition, &context);
+            wheelNs = secondsSince(start) * 1e9 / context.expired;
+
+            // Otkazivanje i ponovno zakazivanje (npr. kasnjenje autobusa)
+            int cancels = size < 1000000 ? size : 1000000;
+            for (int i = 0; i < size; ++i)
+                handles[i] = scheduleTimer(*wheel, tick + initial[i].tick, initial[i].payload);
+            start = std::chrono::steady_clock::now();
+            for (int i = 0; i < cancels; ++i) {
+                cancelTimer(*wheel, handles[i]);
+                handles[i] = scheduleTimer(*wheel, tick + initial[i].tick + 1000, initial[i].payload);
+            }
+            cancelNs = secondsSince(start) * 1e9 / cancels;
+            delete wheel;
+        }
+
+        std::cout << size << " zakazanih dogadjaja: std::priority_queue " << heapNs << " ns/dogadjaj, tocak tajmera "
+            << wheelNs << " ns/dogadjaj (" << heapNs / wheelNs << "x), otkazivanje + zakazivanje "
+            << cancelNs << " ns" << std::endl;
+    }
+    return 0;
+}
+
+// Polozaj na putanji binarnom pretragom tabele duzine luka, bez pamcenja kursora (za poredjenje)
+static void findRouteEdge(const RoutePath& route, int segment, float t, int& edge, float& edgeT) {
+    const float* first = route.cumulativeLength.data() + route.segmentOffsets[segment];
+    const float* last = route.cumulativeLength.data() + route.segmentOffsets[segment + 1];
+    float distance = t * route.segmentLength[segment];
+    const float* upper = std::upper_bound(first + 1, last - 1, distance);
+    edge = (int)(upper - 1 - route.cumulativeLength.data());
+
+    const float* cumulative = route.cumulativeLength.data();
+    float edgeLength = cumulative[edge + 1] - cumulative[edge];
+    edgeT = edgeLength > 0.0f ? (distance - cumulative[edge]) / edgeLength : 1.0f;
+    edgeT = edgeT > 1.0f ? 1.0f : edgeT;
+}
+
+// Pracenje putanje sa 100K tacaka za 100K autobusa: kursor naspram binarne pretrage
+static int benchmarkPath() {
+    Network network;
+    makeLoopNetwork(network, NUM_STATIONS, ROUTE_AXIS_A, ROUTE_AXIS_B);
+
+    RoutePath route;
+    buildRoutePath(route, network, PATH_BENCH_POINTS_PER_SEGMENT, WIGGLE_RANGE, BENCH_SEED);
+    std::cout << "Putanja: " << route.points.size() / 2 << " tacaka, " << PATH_BENCH_BUSES << " autobusa, "
+        << PATH_BENCH_TICKS << " koraka" << std::endl;
+
+    // Autobusi voze stalno (bez stajanja) i prelaze na sledeci segment kad zavrse tekuci
+    const int n = PATH_BENCH_BUSES;
+    std::vector<int> segment(n);
+    std::vector<float> segmentTime(n);
+    RandomStream stream = makeRandomStream(BENCH_SEED, STREAM_BUS, 0);
+    for (int i = 0; i < n; ++i) {
+        segment[i] = randomInt(stream, network.numSegments);
+        segmentTime[i] = TRAVEL_TIME_SECONDS * randomFloat(stream);
+    }
+
+    std::vector<int> edge(n, 0), searchEdge(n, 0);
+    std::vector<float> edgeT(n, 0.0f), searchEdgeT(n, 0.0f);
+    double cursorSeconds = 0.0;
+    double searchSeconds = 0.0;
+    long long mismatches = 0;
+
+    for (int tick = 0; tick < PATH_BENCH_TICKS; ++tick) {
+        for (int i = 0; i < n; ++i) {
+            segmentTime[i] += SIMULATION_STEP_SECONDS;
+            if (segmentTime[i] >= TRAVEL_TIME_SECONDS) {
+                segmentTime[i] -= TRAVEL_TIME_SECONDS;
+                segment[i] = segment[i] + 1 == network.numSegments ? 0 : segment[i] + 1;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < n; ++i)
+            advanceRouteCursor(route, segment[i], segmentTime[i] / TRAVEL_TIME_SECONDS, edge[i], edgeT[i]);
+        cursorSeconds += secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < n; ++i)
+            findRouteEdge(route, segment[i], segmentTime[i] / TRAVEL_TIME_SECONDS, searchEdge[i], searchEdgeT[i]);
+        searchSeconds += secondsSince(start);
+
+        for (int i = 0; i < n; ++i)
+            mismatches += edge[i] != searchEdge[i] && !(edgeT[i] == 1.0f && searchEdgeT[i] == 0.0f);
+    }
+
+    double updates = (double)n * PATH_BENCH_TICKS;
+    double cursorNs = cursorSeconds * 1e9 / updates;
+    double searchNs = searchSeconds * 1e9 / updates;
+    std::cout << "Kursor: " << cursorNs << " ns/autobusu, binarna pretraga: " << searchNs
+        << " ns/autobusu (" << searchNs / cursorNs << "x)" << std::endl;
+    if (mismatches != 0)
+        std::cout << "Razlicitih ivica: " << mismatches << std::endl;
+    return 0;
+}
+
+// Mreza u obliku resetke side x side stanica: svaki red i svaka kolona je linija koja ide do kraja
+// i vraca se nazad (tamo i nazad deli stanice, a susedne linije se seku); segmenti se ne prave
+static void makeGridNetwork(Network& network, int side) {
+    network = Network();
+    network.numStops = side * side;
+    network.numRoutes = 2 * side;
+    network.stopPositions.resize((size_t)network.numStops * 2);
+    for (int row = 0; row < side; ++row) {
+        for (int column = 0; column < side; ++column) {
+            int stop = row * side + column;
+            network.stopPositions[2 * stop] = -0.9f + 1.8f * column / (side - 1);
+            network.stopPositions[2 * stop + 1] = -0.9f + 1.8f * row / (side - 1);
+        }
+    }
+
+    // Linija r < side je red r, ostale su kolone
+    network.routeOffsets.assign(network.numRoutes + 1, 0);
+    network.routeStops.reserve((size_t)network.numRoutes * (2 * side - 2));
+    for (int r = 0; r < network.numRoutes; ++r) {
+        int line = r % side;
+        for (int k = 0; k < 2 * side - 2; ++k) {
+            int position = k < side ? k : 2 * side - 2 - k;
+            network.routeStops.push_back(r < side ? line * side + position : position * side + line);
+        }
+        network.routeOffsets[r + 1] = (int)network.routeStops.size();
+    }
+    markNetworkChanged(network);
+}
+
+// Pravljenje CSR mreze sa milion stanica, memorija po milion stanica i korak flote na njoj
+static int benchmarkNetwork() {
+    Network network;
+    makeGridNetwork(network, NETWORK_BENCH_SIDE);
+
+    auto start = std::chrono::steady_clock::now();
+    if (!buildNetworkSegments(network))
+        return -1;
+    double buildSeconds = secondsSince(start);
+    printNetworkSummary(network);
+    std::cout << "Pravljenje segmenata: " << buildSeconds * 1000.0 << " ms" << std::endl;
+
+    Fleet fleet;
+    initFleet(fleet, NETWORK_BENCH_BUSES, network, BENCH_SEED);
+    long long arrivals = 0;
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < NETWORK_BENCH_TICKS; ++t)
+        arrivals += tickFleet(fleet, SIMULATION_STEP_SECONDS, network);
+    double tickSeconds = secondsSince(start);
+    std::cout << "Flota " << NETWORK_BENCH_BUSES << " autobusa, " << NETWORK_BENCH_TICKS << " koraka: "
+        << (double)NETWORK_BENCH_BUSES * NETWORK_BENCH_TICKS / (tickSeconds * 1000.0) << " autobus-koraka/ms, "
+        << arrivals << " dolazaka" << std::endl;
+    return 0;
+}
+
+// 10M putnika u isto vreme: pojavljivanje, ulazak i izlazak u koracima simulacije, bez zauzimanja memorije
+static int benchmarkPassengers() {
+    Network network;
+    makeGridNetwork(network, PASSENGER_BENCH_SIDE);
+    buildNetworkSegments(network);
+
+    // Potraznja je podesena tako da se pool napuni i ostane pun (putnici koji izlaze oslobadjaju mesta)
+    Simulation sim;
+    SimulationConfig config;
+    config.numBuses = PASSENGER_BENCH_BUSES;
+    config.passengerCapacity = PASSENGER_BENCH_CAPACITY;
+    config.demand = 1.0;
+    config.seed = BENCH_SEED;
+    initSimulation(sim, network, config);
+    spawnPassengers(sim.passengers, sim.network, (double)PASSENGER_BENCH_CAPACITY / sim.network.routeStops.size(), BENCH_SEED);
+    std::cout << "Putnika: " << sim.passengers.count << ", autobusa: " << sim.fleet.size << ", mesta na linijama: "
+        << sim.network.routeStops.size() << std::endl;
+
+    long long allocationsBefore = getAllocationCount();
+    long long boardedBefore = sim.passengers.boardedCount;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < PASSENGER_BENCH_TICKS; ++t)
+        stepSimulation(sim, SIMULATION_STEP_SECONDS);
+    double seconds = secondsSince(start);
+    long long allocations = getAllocationCount() - allocationsBefore;
+    long long boarded = sim.passengers.boardedCount - boardedBefore;
+
+    std::cout << PASSENGER_BENCH_TICKS << " koraka: " << seconds * 1000.0 / PASSENGER_BENCH_TICKS << " ms po koraku, "
+        << (double)boarded / PASSENGER_BENCH_TICKS << " ulazaka po koraku (najvise " << sim.maxTickBoardings << "), "
+        << boarded / (seconds * 1000.0) << " ulazaka/ms" << std::endl;
+    std::cout << "Putnika na kraju: " << sim.passengers.count << ", zauzimanja memorije tokom koraka: "
+        << formatAllocations(allocations) << std::endl;
+    return allocations == 0 ? 0 : -1;
+}
+
+// Red kao povezana lista kroz niz "next" (kako su redovi bili pre kruznih bafera), za poredjenje
+struct LinkedQueues {
+    std::vector<int> head, tail, next;
+};
+
+static void pushLinked(LinkedQueues& queues, int queue, int value) {
+    queues.next[value] = -1;
+    if (queues.tail[queue] < 0)
+        queues.head[queue] = value;
+    else
+        queues.next[queues.tail[queue]] = value;
+    queues.tail[queue] = value;
+}
+
+static int popLinked(LinkedQueues& queues, int queue, int* out, int maxCount) {
+    int count = 0;
+    int value = queues.head[queue];
+    while (value >= 0 && count < maxCount) {
+        out[count++] = value;
+        value = queues.next[value];
+    }
+    queues.head[queue] = value;
+    if (value < 0)
+        queues.tail[queue] = -1;
+    return count;
+}
+
+// Vrsni sat na 10K stanica: cela simulacija, pa samo redovi (kruzni baferi naspram povezane liste)
+static int benchmarkBoarding() {
+    Network network;
+    makeGridNetwork(network, BOARDING_BENCH_SIDE);
+    buildNetworkSegments(network);
+    const int numSlots = (int)network.routeStops.size();
+
+    Simulation sim;
+    SimulationConfig config;
+    config.numBuses = BOARDING_BENCH_BUSES;
+    config.passengerCapacity = BOARDING_BENCH_CAPACITY;
+    config.demand = BOARDING_BENCH_DEMAND;
+    config.seed = BENCH_SEED;
+    initSimulation(sim, network, config);
+    spawnPassengers(sim.passengers, sim.network, BOARDING_BENCH_WAITING / BOARDING_BENCH_DEMAND, BENCH_SEED);
+    std::cout << "Stanica: " << network.numStops << ", mesta na linijama: " << numSlots << ", autobusa: "
+        << sim.fleet.size << ", putnika na pocetku: " << sim.passengers.count << std::endl;
+
+    int ticks = (int)(BOARDING_BENCH_SECONDS / SIMULATION_STEP_SECONDS + 0.5);
+    long long boardedBefore = sim.passengers.boardedCount;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t)
+        stepSimulation(sim, SIMULATION_STEP_SECONDS);
+    double seconds = secondsSince(start);
+    long long boarded = sim.passengers.boardedCount - boardedBefore;
+    std::cout << "Simulacija, " << ticks << " koraka: " << seconds * 1000.0 / ticks << " ms po koraku, "
+        << (double)boarded / ticks << " ulazaka po koraku (najvise " << sim.maxTickBoardings << "), "
+        << sim.passengers.queues.growCount << " povecanja redova" << std::endl;
+
+    // Samo redovi: svako mesto ima BOARDING_BENCH_WAITING putnika rasutih po memoriji; autobus
+    // odjednom uzima MAX_PASSENGERS, a isto toliko novih putnika staje u red
+    const int numPassengers = numSlots * BOARDING_BENCH_WAITING;
+    std::vector<int> passengerIds(numPassengers);
+    RandomStream stream = makeRandomStream(BENCH_SEED, STREAM_PASSENGER, 0);
+    for (int i = 0; i < numPassengers; ++i)
+        passengerIds[i] = i;
+    for (int i = numPassengers - 1; i > 0; --i)
+        std::swap(passengerIds[i], passengerIds[randomInt(stream, i + 1)]);
+
+    StopQueues ring;
+    initStopQueues(ring, numSlots, numPassengers * 2);
+    LinkedQueues linked;
+    linked.head.assign(numSlots, -1);
+    linked.tail.assign(numSlots, -1);
+    linked.next.assign(numPassengers, -1);
+    for (int i = 0; i < numPassengers; ++i) {
+        pushQueue(ring, i % numSlots, passengerIds[i]);
+        pushLinked(linked, i % numSlots, passengerIds[i]);
+    }
+
+    int seats[MAX_PASSENGERS];
+    long long ringBoarded = 0;
+    long long checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BOARDING_BENCH_ROUNDS; ++round) {
+        for (int slot = 0; slot < numSlots; ++slot) {
+            int count = popQueue(ring, slot, seats, MAX_PASSENGERS);
+            for (int k = 0; k < count; ++k)
+                pushQueue(ring, slot, seats[k]);
+            ringBoarded += count;
+            checksum += seats[0];
+        }
+    }
+    double ringSeconds = secondsSince(start);
+
+    long long linkedBoarded = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BOARDING_BENCH_ROUNDS; ++round) {
+        for (int slot = 0; slot < numSlots; ++slot) {
+            int count = popLinked(linked, slot, seats, MAX_PASSENGERS);
+            for (int k = 0; k < count; ++k)
+                pushLinked(linked, slot, seats[k]);
+            linkedBoarded += count;
+            checksum -= seats[0];
+        }
+    }
+    double linkedSeconds = secondsSince(start);
+
+    double ringNs = ringSeconds * 1e9 / ringBoarded;
+    double linkedNs = linkedSeconds * 1e9 / linkedBoarded;
+    std::cout << "Redovi, " << ringBoarded << " ulazaka: kruzni bafer " << ringNs << " ns/putniku, povezana lista "
+        << linkedNs << " ns/putniku (" << linkedNs / ringNs << "x)" << std::endl;
+    return checksum == 0 ? 0 : -1;
+}
+
+// Prazni sve autobuse i puni ih novim putnicima (sa kartom ili bez nje, po TICKET_PROBABILITY)
+static void fillBuses(Passengers& passengers, Fleet& fleet, const Network& network, unsigned long long& serial) {
+    for (int bus = 0; bus < fleet.size; ++bus) {
+        while (fleet.load[bus] > 0)
+            removeSeatedPassenger(passengers, fleet, bus, fleet.load[bus] - 1);
+        while (fleet.load[bus] < MAX_PASSENGERS) {
+            RandomStream stream = makeRandomStream(BENCH_SEED, STREAM_PASSENGER, (unsigned int)serial++);
+            int passenger = createPassenger(passengers, network, randomInt(stream, (int)network.routeStops.size()), stream);
+            seatPassenger(passengers, fleet, bus, passenger, 0.0f);
+        }
+    }
+}
+
+// Kontrole u 100K punih autobusa: brojanje putnika bez karte popcount-om naspram citanja svakog
+// putnika, i izbacivanje tacno tih putnika
+static int benchmarkInspections() {
+    Network network;
+    makeLoopNetwork(network, NUM_STATIONS, ROUTE_AXIS_A, ROUTE_AXIS_B);
+    Fleet fleet;
+    initFleet(fleet, INSPECTION_BENCH_BUSES, network, BENCH_SEED);
+    Passengers passengers;
+    initPassengers(passengers, network, fleet.size, fleet.size * MAX_PASSENGERS, 0.0);
+    unsigned long long serial = 0;
+
+    double countSeconds = 0.0, scanSeconds = 0.0, inspectSeconds = 0.0;
+    long long counted = 0, scanned = 0, fined = 0;
+    for (int round = 0; round < INSPECTION_BENCH_ROUNDS; ++round) {
+        fillBuses(passengers, fleet, network, serial);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int bus = 0; bus < fleet.size; ++bus)
+            counted += countFareEvaders(passengers, fleet, bus);
+        countSeconds += secondsSince(start);
+
+        // Isto brojanje bez niza bitova: karta svakog putnika se cita iz kolone hasTicket
+        start = std::chrono::steady_clock::now();
+        for (int bus = 0; bus < fleet.size; ++bus) {
+            const int* seats = passengers.seats.data() + (size_t)bus * MAX_PASSENGERS;
+            for (int seat = 0; seat < fleet.load[bus]; ++seat)
+                scanned += passengers.hasTicket[seats[seat]] == 0;
+        }
+        scanSeconds += secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int bus = 0; bus < fleet.size; ++bus)
+            fined += inspectBus(passengers, fleet, bus);
+        inspectSeconds += secondsSince(start);
+    }
+
+    double inspections = (double)fleet.size * INSPECTION_BENCH_ROUNDS;
+    double countNs = countSeconds * 1e9 / inspections;
+    double scanNs = scanSeconds * 1e9 / inspections;
+    std::cout << INSPECTION_BENCH_ROUNDS << " x " << fleet.size << " kontrola (po " << MAX_PASSENGERS << " putnika): "
+        << "brojanje popcount-om " << countNs << " ns/autobusu, citanjem putnika " << scanNs << " ns/autobusu ("
+        << scanNs / countNs << "x), kontrola sa izbacivanjem " << inspectSeconds * 1e9 / inspections
+        << " ns/autobusu" << std::endl;
+    std::cout << "Putnika bez karte: " << fined << " (" << 100.0 * fined / (inspections * MAX_PASSENGERS) << "%)" << std::endl;
+    return counted == scanned && counted == fined ? 0 : -1;
+}
+
+// Ista simulacija bez kontrolora i sa 10K kontrolora (po svakom pravilu presedanja): cena
+// kontrolora po koraku i broj zauzimanja memorije tokom koraka
+static int benchmarkInspectors() {
+    Network network;
+    makeGridNetwork(network, INSPECTOR_BENCH_SIDE);
+    buildNetworkSegments(network);
+    int ticks = (int)(INSPECTOR_BENCH_SECONDS / SIMULATION_STEP_SECONDS + 0.5);
+    std::cout << "Stanica: " << network.numStops << ", autobusa: " << INSPECTOR_BENCH_BUSES << ", " << ticks
+        << " koraka" << std::endl;
+
+    const char* policyNames[] = { "bez kontrolora", "next", "loaded", "random" };
+    const int policies[] = { TRANSFER_NEXT_BUS, TRANSFER_NEXT_BUS, TRANSFER_LOADED_BUS, TRANSFER_RANDOM_BUS };
+    double baseline = 0.0;
+    long long totalAllocations = 0;
+    for (int run = 0; run < 4; ++run) {
+        SimulationConfig config;
+        config.numBuses = INSPECTOR_BENCH_BUSES;
+        config.passengerCapacity = INSPECTOR_BENCH_CAPACITY;
+        config.numInspectors = run == 0 ? 0 : INSPECTOR_BENCH_INSPECTORS;
+        config.transferPolicy = policies[run];
+        config.seed = BENCH_SEED;
+        Simulation sim;
+        initSimulation(sim, network, config);
+
+        long long allocationsBefore = getAllocationCount();
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; ++t)
+            stepSimulation(sim, SIMULATION_STEP_SECONDS);
+        double seconds = secondsSince(start);
+        long long allocations = getAllocationCount() - allocationsBefore;
+        totalAllocations += allocations;
+
+        double msPerTick = seconds * 1000.0 / ticks;
+        if (run == 0)
+            baseline = msPerTick;
+        const Inspectors& inspectors = sim.inspectors;
+        std::cout << policyNames[run] << ": " << msPerTick << " ms po koraku (" << msPerTick / baseline << "x), "
+            << inspectors.inspectionsCount << " kontrola, " << inspectors.finedCount << " kaznjenih, "
+            << inspectors.transfersCount << " presedanja, zauzimanja memorije: " << formatAllocations(allocations) << std::endl;
+    }
+    return totalAllocations == 0 ? 0 : -1;
+}
+
+// Upis i ucitavanje snimka sa 10M putnika; ucitano stanje mora da se nastavi isto kao originalno
+static int benchmarkSnapshot() {
+    Network network;
+    makeGridNetwork(network, PASSENGER_BENCH_SIDE);
+    buildNetworkSegments(network);
+
+    SimulationConfig config;
+    config.numBuses = PASSENGER_BENCH_BUSES;
+    config.passengerCapacity = PASSENGER_BENCH_CAPACITY;
+    config.demand = 1.0;
+    config.numInspectors = PASSENGER_BENCH_BUSES / 10;
+    config.seed = BENCH_SEED;
+    Simulation sim;
+    initSimulation(sim, network, config);
+    spawnPassengers(sim.passengers, sim.network, (double)PASSENGER_BENCH_CAPACITY / sim.network.routeStops.size(), BENCH_SEED);
+    for (int t = 0; t < SNAPSHOT_BENCH_TICKS; ++t)
+        stepSimulation(sim, SIMULATION_STEP_SECONDS);
+    std::cout << "Putnika: " << sim.passengers.count << ", autobusa: " << sim.fleet.size << ", kontrolora: "
+        << sim.inspectors.count << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    if (!saveSnapshot(SNAPSHOT_BENCH_FILE, sim, nullptr))
+        return -1;
+    double saveSeconds = secondsSince(start);
+
+    // Prvo ucitavanje u praznu simulaciju placa i prvo dodirivanje novozauzete memorije; drugo
+    // ucitava u iste nizove (kao vracanje na sacuvano stanje u toku rada)
+    Simulation restored;
+    start = std::chrono::steady_clock::now();
+    bool loaded = loadSnapshot(SNAPSHOT_BENCH_FILE, restored, nullptr);
+    double coldSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    loaded = loaded && loadSnapshot(SNAPSHOT_BENCH_FILE, restored, nullptr);
+    double warmSeconds = secondsSince(start);
+    remove(SNAPSHOT_BENCH_FILE);
+    if (!loaded)
+        return -1;
+
+    std::cout << "Upis: " << saveSeconds * 1000.0 << " ms, ucitavanje u novu simulaciju: " << coldSeconds * 1000.0
+        << " ms, u postojecu: " << warmSeconds * 1000.0 << " ms" << std::endl;
+
+    // Obe simulacije nastavljaju isto
+    for (int t = 0; t < SNAPSHOT_BENCH_TICKS; ++t) {
+        stepSimulation(sim, SIMULATION_STEP_SECONDS);
+        stepSimulation(restored, SIMULATION_STEP_SECONDS);
+    }
+    bool same = sim.passengers.boardedCount == restored.passengers.boardedCount
+        && sim.passengers.alightedCount == restored.passengers.alightedCount
+        && sim.inspectors.finedCount == restored.inspectors.finedCount
+        && sim.fleet.load == restored.fleet.load;
+    std::cout << "Nastavak posle ucitavanja: " << (same ? "isti" : "RAZLICIT") << std::endl;
+    return same ? 0 : -1;
+}
+
+// Cena jednog logEvent: kad je dnevnik iskljucen, kad je ukljucen (u talasima koji staju u bafer,
+// kao dogadjaji simulacije, i u neprekidnoj petlji koja puni bafer) i poredjenje sa ispisom
+// teksta uz praznjenje posle svake linije (kao std::cout << ... << std::endl)
+static int benchmarkLogger() {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < LOGGER_BENCH_EVENTS; ++i)
+        logEvent(LOG_BOARDING, i * 0.001, i & 1023, i & 4095, i & 31);
+    double disabledSeconds = secondsSince(start);
+
+    if (!startLog(LOGGER_BENCH_FILE))
+        return -1;
+
+    // Talasi od pola bafera, sa pauzom da ih pozadinska nit upise
+    const int burst = LOG_RING_RECORDS / 2;
+    double burstSeconds = 0.0;
+    for (int done = 0; done < LOGGER_BENCH_EVENTS; done += burst) {
+        start = std::chrono::steady_clock::now();
+        int end = done + burst < LOGGER_BENCH_EVENTS ? done + burst : LOGGER_BENCH_EVENTS;
+        for (int i = done; i < end; ++i)
+            logEvent(LOG_BOARDING, i * 0.001, i & 1023, i & 4095, i & 31);
+        burstSeconds += secondsSince(start);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    long long burstDropped = getDroppedLogCount();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < LOGGER_BENCH_EVENTS; ++i)
+        logEvent(LOG_ALIGHTING, i * 0.001, i & 1023, i & 4095, i & 31);
+    double floodSeconds = secondsSince(start);
+    stopLog();
+    long long floodDropped = getDroppedLogCount() - burstDropped;
+    long long logged = getLoggedCount();
+    remove(LOGGER_BENCH_FILE);
+
+    FILE* text = fopen(LOGGER_BENCH_TEXT_FILE, "w");
+    if (text == nullptr)
+        return -1;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < LOGGER_BENCH_TEXT_EVENTS; ++i) {
+        fprintf(text, "%12.3f s  autobus %d: uslo %d putnika na stanici %d\n", i * 0.001, i & 1023, i & 31, i & 4095);
+        fflush(text);
+    }
+    double textSeconds = secondsSince(start);
+    fclose(text);
+    remove(LOGGER_BENCH_TEXT_FILE);
+
+    double burstNs = burstSeconds * 1e9 / LOGGER_BENCH_EVENTS;
+    double textNs = textSeconds * 1e9 / LOGGER_BENCH_TEXT_EVENTS;
+    std::cout << "logEvent, dnevnik iskljucen: " << disabledSeconds * 1e9 / LOGGER_BENCH_EVENTS << " ns" << std::endl;
+    std::cout << "logEvent, talasi od " << burst << " zapisa: " << burstNs << " ns, odbaceno " << burstDropped << std::endl;
+    std::cout << "logEvent, neprekidno: " << floodSeconds * 1e9 / LOGGER_BENCH_EVENTS << " ns, odbaceno " << floodDropped
+        << " od " << LOGGER_BENCH_EVENTS << std::endl;
+    std::cout << "Tekst sa praznjenjem posle svake linije: " << textNs << " ns (" << textNs / burstNs << "x)" << std::endl;
+    std::cout << "Upisano zapisa: " << logged << std::endl;
+    return burstDropped == 0 && logged + floodDropped == 2LL * LOGGER_BENCH_EVENTS ? 0 : -1;
+}
+
+// Provera procitane telemetrije: broj redova i poslednji uzorak
+struct TelemetryCheck {
+    long long rows = 0;
+    std::vector<int> lastSegment;
+    std::vector<int> lastLoad;
+};
+
+static void checkTelemetryChunk(void* user, const TelemetryChunk& chunk) {
+    TelemetryCheck& check = *(TelemetryCheck*)user;
+    check.rows += (long long)chunk.samples * chunk.numBuses;
+    size_t last = (size_t)(chunk.samples - 1) * chunk.numBuses;
+    check.lastSegment.assign(chunk.segment.begin() + last, chunk.segment.end());
+    check.lastLoad.assign(chunk.load.begin() + last, chunk.load.end());
+}
+
+// Simulirani dan sa telemetrijom cele flote na 10 Hz: cena uzorka za simulaciju (i najduzi uzorak;
+// na jednom jezgru u njega ulazi i vreme kad je pozadinska nit dobila procesor), velicina fajla po redu i provera da nijedan uzorak nije odbacen i da se
+// fajl cita nazad
+static int benchmarkTelemetry() {
+    Network network;
+    makeGridNetwork(network, INSPECTOR_BENCH_SIDE);
+    buildNetworkSegments(network);
+    SimulationConfig config;
+    config.numBuses = TELEMETRY_BENCH_BUSES;
+    config.passengerCapacity = INSPECTOR_BENCH_CAPACITY;
+    config.seed = BENCH_SEED;
+    Simulation sim;
+    initSimulation(sim, network, config);
+
+    if (!startTelemetry(TELEMETRY_BENCH_FILE, sim.fleet.size, TELEMETRY_INTERVAL_SECONDS, false))
+        return -1;
+    float step = (float)TELEMETRY_INTERVAL_SECONDS;
+    long long ticks = (long long)(TELEMETRY_BENCH_SECONDS / TELEMETRY_INTERVAL_SECONDS + 0.5);
+    long long allocations = 0;
+    double recordSeconds = 0.0;
+    double maxRecordSeconds = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (long long t = 0; t < ticks; ++t) {
+        stepSimulation(sim, step);
+        long long allocationsBefore = getAllocationCount();
+        auto recordStart = std::chrono::steady_clock::now();
+        recordTelemetry(sim);
+        double seconds = secondsSince(recordStart);
+        allocations += getAllocationCount() - allocationsBefore;
+        recordSeconds += seconds;
+        maxRecordSeconds = seconds > maxRecordSeconds ? seconds : maxRecordSeconds;
+    }
+    double runSeconds = secondsSince(start);
+    auto stopStart = std::chrono::steady_clock::now();
+    stopTelemetry();
+    double stopSeconds = secondsSince(stopStart);
+    TelemetryStats stats = getTelemetryStats();
+
+    start = std::chrono::steady_clock::now();
+    TelemetryCheck check;
+    bool read = readTelemetry(TELEMETRY_BENCH_FILE, checkTelemetryChunk, &check);
+    double readSeconds = secondsSince(start);
+    remove(TELEMETRY_BENCH_FILE);
+
+    double rows = (double)stats.samples * sim.fleet.size;
+    std::cout << "Autobusa: " << sim.fleet.size << ", simulirano " << TELEMETRY_BENCH_SECONDS / 3600.0 << " h, "
+        << stats.samples << " uzoraka (" << stats.droppedSamples << " odbaceno), " << rows << " redova" << std::endl;
+    std::cout << "Simulacija sa telemetrijom: " << runSeconds << " s, uzorak: " << recordSeconds * 1e9 / rows
+        << " ns po autobusu, najduzi " << maxRecordSeconds * 1e6 << " us, zavrsni upis " << stopSeconds * 1000.0
+        << " ms, zauzimanja memorije pri uzorkovanju: " << formatAllocations(allocations) << std::endl;
+    std::cout << "Fajl: " << stats.bytes / (1024.0 * 1024.0) << " MB, " << stats.bytes / rows << " B po redu (nekodirano "
+        << sizeof(long long) + 4 * sizeof(int) << " B), memorija blokova " << stats.memoryBytes / (1024.0 * 1024.0) << " MB" << std::endl;
+    std::cout << "Pozadinska nit: " << stats.writerSeconds << " s (" << rows / stats.writerSeconds / 1e6
+        << "M redova/s, " << stats.writerSeconds / TELEMETRY_BENCH_SECONDS * 100.0 << "% simuliranog vremena)" << std::endl;
+    std::cout << "Citanje: " << readSeconds << " s (" << rows / readSeconds / 1e6 << "M redova/s)" << std::endl;
+
+    bool same = read && check.rows == (long long)rows && check.lastSegment == sim.fleet.segment && check.lastLoad == sim.fleet.load;
+    std::cout << "Procitana telemetrija: " << (same ? "ista" : "RAZLICITA") << std::endl;
+    return same && stats.droppedSamples == 0 && allocations == 0 ? 0 : -1;
+}
+
+// Cena upisa u histogram i brojac (jedna nit i dve niti u isti histogram), citanja sata i ispisa
+// svih metrika; percentili histograma se porede sa tacnim percentilima istih vrednosti
+static int benchmarkMetrics() {
+    int histogram = registerMetric(METRIC_HISTOGRAM, "autobus_bench_seconds", nullptr, "Merenje histograma", 1e-9);
+    int counter = registerMetric(METRIC_COUNTER, "autobus_bench_total", nullptr, "Merenje brojaca");
+    if (histogram < 0 || counter < 0)
+        return -1;
+
+    // Vrednosti sa dugim repom (kao trajanja), unapred izracunate da merenje ne bi merilo generator
+    RandomStream stream = makeRandomStream(BENCH_SEED, STREAM_BUS, 0);
+    std::vector<unsigned long long> values(METRICS_BENCH_VALUES);
+    for (int i = 0; i < METRICS_BENCH_VALUES; ++i) {
+        float u = randomFloat(stream);
+        values[i] = (unsigned long long)(1000.0 / (1.0 - 0.999 * u));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < METRICS_BENCH_RECORDS; ++i)
+        recordHistogram(histogram, values[i % METRICS_BENCH_VALUES]);
+    double histogramSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < METRICS_BENCH_RECORDS; ++i)
+        addCounter(counter, 1);
+    double counterSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    unsigned long long lastClock = 0;
+    for (int i = 0; i < METRICS_BENCH_RECORDS / 10; ++i)
+        lastClock = getMetricsClock();
+    double clockSeconds = secondsSince(start);
+    if (lastClock == 0)
+        return -1;
+
+    // Dve niti u isti histogram (korpe se dele, pa se vidi cena deljenja linija kesa)
+    start = std::chrono::steady_clock::now();
+    std::thread other([&]() {
+        for (int i = 0; i < METRICS_BENCH_RECORDS / 2; ++i)
+            recordHistogram(histogram, values[i % METRICS_BENCH_VALUES]);
+    });
+    for (int i = METRICS_BENCH_RECORDS / 2; i < METRICS_BENCH_RECORDS; ++i)
+        recordHistogram(histogram, values[i % METRICS_BENCH_VALUES]);
+    other.join();
+    double sharedSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    std::string text = formatMetrics();
+    double formatSeconds = secondsSince(start);
+
+    std::cout << "recordHistogram: " << histogramSeconds * 1e9 / METRICS_BENCH_RECORDS << " ns, dve niti: "
+        << sharedSeconds * 1e9 / METRICS_BENCH_RECORDS << " ns, addCounter: " << counterSeconds * 1e9 / METRICS_BENCH_RECORDS
+        << " ns, getMetricsClock: " << clockSeconds * 1e9 / (METRICS_BENCH_RECORDS / 10) << " ns" << std::endl;
+    std::cout << "formatMetrics: " << formatSeconds * 1e6 << " us, " << text.size() << " bajtova" << std::endl;
+
+    // Histogram je dobio svaku vrednost 2 * METRICS_BENCH_RECORDS / METRICS_BENCH_VALUES puta, pa su
+    // percentili isti kao percentili niza values
+    std::sort(values.begin(), values.end());
+    const double percents[] = { 50.0, 90.0, 99.0, 99.9 };
+    double maxError = 0.0;
+    for (double percent : percents) {
+        double exact = values[(size_t)(percent / 100.0 * METRICS_BENCH_VALUES + 0.5) - 1] * 1e-9;
+        double estimate = getHistogramPercentile(histogram, percent);
+        double error = (estimate - exact) / exact;
+        maxError = error > maxError ? error : (-error > maxError ? -error : maxError);
+        std::cout << "p" << percent << ": " << estimate * 1e6 << " us (tacno " << exact * 1e6 << " us)" << std::endl;
+    }
+    bool counted = getHistogramCount(histogram) == 2LL * METRICS_BENCH_RECORDS;
+    std::cout << "Najveca relativna greska percentila: " << maxError * 100.0 << "% (dozvoljeno "
+        << 100.0 / HISTOGRAM_SUB_BUCKETS << "%)" << std::endl;
+    return counted && maxError <= 1.0 / HISTOGRAM_SUB_BUCKETS ? 0 : -1;
+}
+
+static int clampSamples(double samples) {
+    return samples < SUITE_MIN_SAMPLES ? SUITE_MIN_SAMPLES : (samples > SUITE_MAX_SAMPLES ? SUITE_MAX_SAMPLES : (int)samples);
+}
+
+// Korak flote (stanice i segmenti: cekanje, polazak, voznja, dolazak) za 1 do 10M autobusa na
+// mrezi od 10K stanica; uzorak je prosecno trajanje jednog koraka u nizu od batch koraka
+static void addFleetTickSeries(BenchmarkReport& report, long long maxBuses) {
+    Network network;
+    makeGridNetwork(network, INSPECTOR_BENCH_SIDE);
+    buildNetworkSegments(network);
+    for (int size : SUITE_FLEET_SIZES) {
+        if (size > maxBuses)
+            break;
+        Fleet fleet;
+        initFleet(fleet, size, network, BENCH_SEED);
+        int batch = size >= SUITE_SAMPLE_BUS_TICKS ? 1 : (int)(SUITE_SAMPLE_BUS_TICKS / size);
+        int count = clampSamples(SUITE_BUS_TICKS / ((double)size * batch));
+        for (int t = 0; t < batch; ++t)
+            tickFleet(fleet, SIMULATION_STEP_SECONDS, network);
+
+        std::vector<double> samples(count);
+        for (int i = 0; i < count; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            for (int t = 0; t < batch; ++t)
+                tickFleet(fleet, SIMULATION_STEP_SECONDS, network);
+            samples[i] = secondsSince(start) * 1e9 / batch;
+        }
+        addBenchmarkSeries(report, "fleet_tick", "buses=" + std::to_string(size), "ns", samples);
+    }
+}
+
+// Pravljenje krivudave putanje (tacke izmedju stanica i tabele duzina) za podrazumevanu liniju,
+// pri sve vecem broju tacaka po segmentu
+static void addRouteSeries(BenchmarkReport& report) {
+    Network network;
+    makeLoopNetwork(network, NUM_STATIONS, ROUTE_AXIS_A, ROUTE_AXIS_B);
+    buildNetworkSegments(network);
+    for (int points : SUITE_ROUTE_POINTS) {
+        int count = clampSamples(SUITE_ROUTE_POINTS_TOTAL / ((double)points * network.numStops));
+        RoutePath route;
+        std::vector<double> samples(count);
+        for (int i = 0; i < count; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            buildRoutePath(route, network, points, WIGGLE_RANGE, BENCH_SEED + i);
+            samples[i] = secondsSince(start) * 1e6;
+        }
+        addBenchmarkSeries(report, "route_build", "points_per_segment=" + std::to_string(points), "us", samples);
+    }
+}
+
+// Svi delovi koji se prate kroz vreme, sa JSON izvestajem (--json <fajl>); --max-buses ogranicava
+// najvecu flotu (za brzu proveru)
+static int runBenchmarkSuite(int argc, char** argv, RenderBenchmarks renderBenchmarks) {
+    const char* jsonPath = getArgument(argc, argv, "--json", SUITE_DEFAULT_JSON);
+    long long maxBuses = getArgumentInt(argc, argv, "--max-buses", SUITE_MAX_BUSES);
+
+    BenchmarkReport report;
+    addFleetTickSeries(report, maxBuses);
+    addRouteSeries(report);
+    bool rendered = true;
+    if (renderBenchmarks != nullptr)
+        rendered = renderBenchmarks(report);
+    else
+        std::cout << "Merenja crtanja preskocena (nema OpenGL-a)" << std::endl;
+    return writeBenchmarkJson(report, jsonPath) && rendered ? 0 : -1;
+}
+
+int runBenchmark(int argc, char** argv, RenderBenchmarks renderBenchmarks) {
+    const char* name = getArgument(argc, argv, "--bench", "fleet");
+
+    if (strcmp(name, "suite") == 0)
+        return runBenchmarkSuite(argc, argv, renderBenchmarks);
+    if (strcmp(name, "fleet") == 0)
+        return benchmarkFleet();
+    if (strcmp(name, "interpolation") == 0)
+        return benchmarkInterpolation();
+    if (strcmp(name, "events") == 0)
+        return benchmarkEventQueues();
+    if (strcmp(name, "path") == 0)
+        return benchmarkPath();
+    if (strcmp(name, "network") == 0)
+        return benchmarkNetwork();
+    if (strcmp(name, "passengers") == 0)
+        return benchmarkPassengers();
+    if (strcmp(name, "boarding") == 0)
+        return benchmarkBoarding();
+    if (strcmp(name, "inspections") == 0)
+        return benchmarkInspections();
+    if (strcmp(name, "inspectors") == 0)
+        return benchmarkInspectors();
+    if (strcmp(name, "snapshot") == 0)
+        return benchmarkSnapshot();
+    if (strcmp(name, "logger") == 0)
+        return benchmarkLogger();
+    if (strcmp(name, "telemetry") == 0)
+        return benchmarkTelemetry();
+    if (strcmp(name, "metrics") == 0)
+        return benchmarkMetrics();
+
+    std::cerr << "Nepoznat benchmark: " << name << std::endl;
+    return -1;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+struct BenchmarkReport;
+
+// Merenja koja traze OpenGL (ucitavanje tekstura, crtanje): daje ih prozor, a dodaju se u izvestaj
+// skupa merenja; vraca false ako OpenGL ne moze da se pokrene
+typedef bool (*RenderBenchmarks)(BenchmarkReport& report);
+
+// Merenje performansi delova simulacije (--bench <ime>)
+// Dostupno: suite, fleet, interpolation, events, path, network, passengers, boarding, inspections, inspectors, snapshot, logger, telemetry, metrics
+// suite: korak flote (1 do 10M autobusa), pravljenje putanje i crtanje (renderBenchmarks), sa
+// percentilima u JSON fajlu (--json <fajl>, --max-buses <broj>)
+int runBenchmark(int argc, char** argv, RenderBenchmarks renderBenchmarks = nullptr);
@@ -0,0 +1,95 @@
+#include "BenchmarkReport.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+
+const int BENCHMARK_JSON_VERSION = 1;
+
+// Percentil po najblizem rangu iz sortiranih uzoraka
+static double getPercentile(const std::vector<double>& sorted, double percent) {
+    size_t rank = (size_t)(percent / 100.0 * sorted.size() + 0.999999);
+    rank = rank < 1 ? 1 : (rank > sorted.size() ? sorted.size() : rank);
+    return sorted[rank - 1];
+}
+
+BenchmarkSummary summarizeBenchmarkSeries(const BenchmarkSeries& series) {
+    BenchmarkSummary summary;
+    if (series.samples.empty())
+        return summary;
+    std::vector<double> sorted(series.samples);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double sample : sorted)
+        sum += sample;
+    summary.min = sorted.front();
+    summary.mean = sum / sorted.size();
+    summary.p50 = getPercentile(sorted, 50.0);
+    summary.p90 = getPercentile(sorted, 90.0);
+    summary.p99 = getPercentile(sorted, 99.0);
+    summary.max = sorted.back();
+    return summary;
+}
+
+void addBenchmarkSeries(BenchmarkReport& report, const char* name, const std::string& variant, const char* unit,
+    const std::vector<double>& samples) {
+    BenchmarkSeries series;
+    series.name = name;
+    series.variant = variant;
+    series.unit = unit;
+    series.samples = samples;
+    report.series.push_back(series);
+
+    BenchmarkSummary summary = summarizeBenchmarkSeries(series);
+    printf("%-18s %-26s %6zu uzoraka  p50 %12.3f  p90 %12.3f  p99 %12.3f %s\n", name, variant.c_str(),
+        samples.size(), summary.p50, summary.p90, summary.p99, unit);
+    fflush(stdout);
+}
+
+// Niska u JSON-u (navodnici, obrnute kose crte i kontrolni znakovi)
+static void writeJsonString(FILE* file, const std::string& text) {
+    fputc('"', file);
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            fprintf(file, "\\%c", c);
+        else if ((unsigned char)c < 0x20)
+            fprintf(file, "\\u%04x", (unsigned char)c);
+        else
+            fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+bool writeBenchmarkJson(const BenchmarkReport& report, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        std::cerr << "Greska pri upisu rezultata merenja u \"" << path << "\"!" << std::endl;
+        return false;
+    }
+    fprintf(file, "{\n  \"version\": %d,\n  \"timestamp\": %lld,\n  \"results\": [", BENCHMARK_JSON_VERSION,
+        (long long)time(nullptr));
+    for (size_t i = 0; i < report.series.size(); ++i) {
+        const BenchmarkSeries& series = report.series[i];
+        BenchmarkSummary summary = summarizeBenchmarkSeries(series);
+        fprintf(file, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+        writeJsonString(file, series.name);
+        fprintf(file, ", \"variant\": ");
+        writeJsonString(file, series.variant);
+        fprintf(file, ", \"unit\": ");
+        writeJsonString(file, series.unit);
+        fprintf(file, ", \"count\": %zu, \"min\": %.6g, \"mean\": %.6g, \"p50\": %.6g, \"p90\": %.6g, \"p99\": %.6g, \"max\": %.6g,",
+            series.samples.size(), summary.min, summary.mean, summary.p50, summary.p90, summary.p99, summary.max);
+        // Sirovi uzorci redom merenja, da bi alati za regresije mogli sami da racunaju raspodelu
+        fprintf(file, "\n     \"samples\": [");
+        for (size_t s = 0; s < series.samples.size(); ++s)
+            fprintf(file, "%s%.15g", s == 0 ? "" : ", ", series.samples[s]);
+        fprintf(file, "]}");
+    }
+    fprintf(file, "\n  ]\n}\n");
+    bool written = fclose(file) == 0;
+    if (written)
+        std::cout << "Rezultati: " << path << " (" << report.series.size() << " serija)" << std::endl;
+    else
+        std::cerr << "Greska pri upisu rezultata merenja u \"" << path << "\"!" << std::endl;
+    return written;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Rezultati skupa merenja (--bench suite) sa percentilima, za pracenje performansi kroz vreme:
+// ispis na konzolu i JSON fajl (--json <fajl>) koji se moze porediti izmedju verzija.
+//
+// Serija je jedno merenje pri jednoj velicini (npr. korak flote sa 1000 autobusa); svaki uzorak je
+// jedno ponavljanje, a percentili se racunaju tacno, iz sortiranih uzoraka.
+
+struct BenchmarkSeries {
+    std::string name;      // Sta se meri (npr. "fleet_tick")
+    std::string variant;   // Velicina ili ulaz (npr. "buses=1000")
+    std::string unit;      // Jedinica uzoraka (npr. "ns")
+    std::vector<double> samples;
+};
+
+struct BenchmarkReport {
+    std::vector<BenchmarkSeries> series;
+};
+
+// Raspodela uzoraka jedne serije
+struct BenchmarkSummary {
+    double min = 0.0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// Dodaje seriju u izvestaj i ispisuje njen red na konzolu
+void addBenchmarkSeries(BenchmarkReport& report, const char* name, const std::string& variant, const char* unit,
+    const std::vector<double>& samples);
+
+// Minimum, prosek, percentili (najblizi rang) i maksimum uzoraka
+BenchmarkSummary summarizeBenchmarkSeries(const BenchmarkSeries& series);
+
+// Upisuje izvestaj kao JSON; vraca false (i ispisuje gresku) ako fajl ne moze da se upise
+bool writeBenchmarkJson(const BenchmarkReport& report, const char* path);
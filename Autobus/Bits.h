@@ -0,0 +1,84 @@
+#pragma once
+
+// Pomocne funkcije za rad sa bitovima (MSVC i GCC/Clang)
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Indeks najnizeg postavljenog bita (x ne sme biti 0)
+inline int countTrailingZeros(unsigned long long x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (int)index;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if ((unsigned)x != 0) {
+        _BitScanForward(&index, (unsigned)x);
+        return (int)index;
+    }
+    _BitScanForward(&index, (unsigned)(x >> 32));
+    return 32 + (int)index;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// Broj postavljenih bitova bez posebne instrukcije (zbirovi po 2, 4 i 8 bitova, pa zbir bajtova)
+inline int countSetBitsPortable(unsigned long long x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+}
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+// MSVC prevodi __popcnt u instrukciju POPCNT bez provere procesora, a nju nemaju procesori pre
+// Nehalem-a i Barcelone, pa se podrska proverava jednom (CPUID 1, ECX bit 23), kao za AVX2 u
+// Interpolation.cpp. GCC i Clang biraju POPCNT samo uz -mpopcnt (ili -march koji ga ima).
+inline bool cpuSupportsPopcnt() {
+    static const bool supported = [] {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 23)) != 0;
+    }();
+    return supported;
+}
+#endif
+
+// Broj postavljenih bitova
+inline int countSetBits(unsigned long long x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    if (cpuSupportsPopcnt())
+        return (int)__popcnt64(x);
+    return countSetBitsPortable(x);
+#elif defined(_MSC_VER) && defined(_M_IX86)
+    if (cpuSupportsPopcnt())
+        return (int)(__popcnt((unsigned)x) + __popcnt((unsigned)(x >> 32)));
+    return countSetBitsPortable(x);
+#elif defined(_MSC_VER)
+    return countSetBitsPortable(x);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+// Indeks najviseg postavljenog bita (x ne sme biti 0)
+inline int highestSetBit(unsigned long long x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return (int)index;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if ((unsigned)(x >> 32) != 0) {
+        _BitScanReverse(&index, (unsigned)(x >> 32));
+        return 32 + (int)index;
+    }
+    _BitScanReverse(&index, (unsigned)x);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(x);
+#endif
+}
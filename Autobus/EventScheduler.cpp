@@ -0,0 +1,134 @@
+#include "EventScheduler.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include <cmath>
+
+// Metrike simulacije vodjene dogadjajima (vidi Metrics.h)
+static const int EVENT_RUN_SECONDS_METRIC = registerMetric(METRIC_HISTOGRAM, "autobus_event_run_seconds", nullptr,
+    "Trajanje obrade dogadjaja do zadatog vremena (runEventsUntil)", 1e-9);
+static const int EVENTS_METRIC = registerMetric(METRIC_COUNTER, "autobus_events_total", nullptr, "Obradjenih dogadjaja");
+
+// Dogadjaj u tocku tajmera: autobus i tip dogadjaja spakovani u jedan broj
+static unsigned long long packEvent(int bus, int type) {
+    return ((unsigned long long)bus << 2) | (unsigned long long)type;
+}
+
+static unsigned long long toEventTick(double seconds) {
+    return (unsigned long long)llround(seconds / EVENT_TICK_SECONDS);
+}
+
+static double toSeconds(unsigned long long tick) {
+    return tick * EVENT_TICK_SECONDS;
+}
+
+static void scheduleEvent(EventScheduler& scheduler, double time, int bus, int type) {
+    scheduleTimer(scheduler.wheel, toEventTick(time), packEvent(bus, type));
+}
+
+void initEventScheduler(EventScheduler& scheduler, const Simulation& sim) {
+    const Fleet& fleet = sim.fleet;
+    scheduler.processedEvents = 0;
+    initTimingWheel(scheduler.wheel, toEventTick(sim.time), fleet.size + 16);
+    scheduler.departureTime.assign(fleet.size, sim.time);
+    scheduler.arrivalTime.assign(fleet.size, sim.time);
+
+    for (int i = 0; i < fleet.size; ++i) {
+        if (fleet.isWaiting[i]) {
+            scheduler.arrivalTime[i] = sim.time - fleet.waitTimer[i];
+            scheduleEvent(scheduler, sim.time + (STATION_WAIT_SECONDS - fleet.waitTimer[i]), i, EVENT_DEPARTURE);
+        }
+        else {
+            scheduler.departureTime[i] = sim.time - fleet.segmentTime[i];
+            scheduleEvent(scheduler, sim.time + (TRAVEL_TIME_SECONDS - fleet.segmentTime[i]), i, EVENT_ARRIVAL);
+        }
+    }
+    scheduleEvent(scheduler, sim.time + PASSENGER_SPAWN_INTERVAL_SECONDS, 0, EVENT_SPAWN);
+}
+
+// Sve sto je obradi dogadjaja potrebno, prosledjeno kroz user pokazivac tocka tajmera
+struct EventContext {
+    EventScheduler* scheduler;
+    Simulation* sim;
+    const EventCallbacks* callbacks;
+};
+
+static void processEvent(void* user, unsigned long long tick, unsigned long long payload) {
+    EventContext& context = *(EventContext*)user;
+    EventScheduler& scheduler = *context.scheduler;
+    Simulation& sim = *context.sim;
+    const EventCallbacks* callbacks = context.callbacks;
+    Fleet& fleet = sim.fleet;
+
+    int bus = (int)(payload >> 2);
+    int type = (int)(payload & 3);
+    double time = toSeconds(tick);
+    sim.time = time;
+
+    switch (type) {
+    case EVENT_DEPARTURE: {
+        departBus(fleet, sim.network, bus);
+        int from = fleet.fromStation[bus];
+        int next = fleet.stationIndex[bus];
+        fleet.isWaiting[bus] = 0;
+        fleet.waitTimer[bus] = 0.0f;
+        fleet.segmentTime[bus] = 0.0f;
+        serveDeparture(sim, bus);
+        scheduler.departureTime[bus] = time;
+        scheduleEvent(scheduler, time + TRAVEL_TIME_SECONDS, bus, EVENT_ARRIVAL);
+        if (callbacks && callbacks->onDeparture)
+            callbacks->onDeparture(callbacks->user, bus, from, next, time);
+        break;
+    }
+    case EVENT_ARRIVAL: {
+        fleet.isWaiting[bus] = 1;
+        fleet.segmentTime[bus] = TRAVEL_TIME_SECONDS;
+        scheduler.arrivalTime[bus] = time;
+        sim.arrivalsCount++;
+        // Kontrolor izlazi na stanici na koju je autobus upravo stigao
+        int fined = serveInspection(sim, bus);
+        serveArrival(sim, bus);
+        scheduleEvent(scheduler, time + STATION_WAIT_SECONDS, bus, EVENT_DEPARTURE);
+        if (fined >= 0 && callbacks && callbacks->onInspection)
+            callbacks->onInspection(callbacks->user, bus, fined, time);
+        if (callbacks && callbacks->onArrival)
+            callbacks->onArrival(callbacks->user, bus, fleet.stationIndex[bus], time);
+        break;
+    }
+    case EVENT_SPAWN:
+        spawnPassengers(sim.passengers, sim.network, PASSENGER_SPAWN_INTERVAL_SECONDS, sim.seed);
+        scheduleEvent(scheduler, time + PASSENGER_SPAWN_INTERVAL_SECONDS, 0, EVENT_SPAWN);
+        break;
+    }
+}
+
+long long runEventsUntil(EventScheduler& scheduler, Simulation& sim, double endTime, const EventCallbacks* callbacks) {
+    PROFILE_FUNCTION();
+    unsigned long long start = getMetricsClock();
+    EventContext context = { &scheduler, &sim, callbacks };
+    unsigned long long endTick = (unsigned long long)floor(endTime / EVENT_TICK_SECONDS + 1e-6);
+    long long processed = advanceTimingWheel(scheduler.wheel, endTick, processEvent, &context);
+    sim.time = endTime;
+    scheduler.processedEvents += processed;
+    addCounter(EVENTS_METRIC, processed);
+    recordHistogram(EVENT_RUN_SECONDS_METRIC, getMetricsClock() - start);
+    return processed;
+}
+
+long long advanceEvents(EventScheduler& scheduler, Simulation& sim, double deltaTime, const EventCallbacks* callbacks) {
+    if (deltaTime > MAX_FRAME_SECONDS)
+        deltaTime = MAX_FRAME_SECONDS;
+
+    long long processed = runEventsUntil(scheduler, sim, sim.time + deltaTime, callbacks);
+    syncFleetTimers(scheduler, sim);
+    return processed;
+}
+
+void syncFleetTimers(const EventScheduler& scheduler, Simulation& sim) {
+    Fleet& fleet = sim.fleet;
+    for (int i = 0; i < fleet.size; ++i) {
+        if (fleet.isWaiting[i])
+            fleet.waitTimer[i] = (float)(sim.time - scheduler.arrivalTime[i]);
+        else
+            fleet.segmentTime[i] = (float)(sim.time - scheduler.departureTime[i]);
+    }
+}
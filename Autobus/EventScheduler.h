@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include "Simulation.h"
+#include "TimingWheel.h"
+
+// Simulacija vodjena dogadjajima: umesto da se tajmeri proveravaju u svakom koraku, za svaki
+// autobus se unapred zna kada ce krenuti i kada ce stici, pa se vreme preskace od dogadjaja do
+// dogadjaja. Cena duge simulacije zavisi od broja dogadjaja, a ne od broja koraka.
+
+enum BusEventType {
+    EVENT_DEPARTURE,   // Autobus polazi sa stanice
+    EVENT_ARRIVAL,     // Autobus stize na sledecu stanicu (kontrolor iz njega tu kaznjava putnike i izlazi)
+    EVENT_SPAWN        // Pojavljuju se novi putnici na stanicama (periodicno, ne vezano za autobus)
+};
+
+// Rezolucija vremena dogadjaja (jedan tik tocka tajmera)
+const double EVENT_TICK_SECONDS = 0.001;
+
+// Koliko cesto se prave novi putnici (putnici nastali u tom periodu pojavljuju se zajedno)
+const double PASSENGER_SPAWN_INTERVAL_SECONDS = 1.0;
+
+// Funkcije koje se pozivaju za svaki obradjeni dogadjaj (npr. za crtanje); svaka moze biti NULL
+struct EventCallbacks {
+    void (*onDeparture)(void* user, int bus, int fromStation, int toStation, double time) = nullptr;
+    void (*onArrival)(void* user, int bus, int station, double time) = nullptr;
+    void (*onInspection)(void* user, int bus, int fined, double time) = nullptr;
+    void* user = nullptr;
+};
+
+struct EventScheduler {
+    TimingWheel wheel;                 // Zakazani dogadjaji (vidi TimingWheel.h)
+    std::vector<double> departureTime; // Kada je autobus krenuo sa poslednje stanice
+    std::vector<double> arrivalTime;   // Kada je autobus stigao na stanicu na kojoj stoji
+    long long processedEvents = 0;
+};
+
+// Zakazuje prvi dogadjaj za svaki autobus na osnovu trenutnog stanja flote
+void initEventScheduler(EventScheduler& scheduler, const Simulation& sim);
+
+// Obradjuje sve dogadjaje do trenutka endTime i pomera sim.time na endTime,
+// vraca broj obradjenih dogadjaja
+long long runEventsUntil(EventScheduler& scheduler, Simulation& sim, double endTime, const EventCallbacks* callbacks);
+
+// Pomera simulaciju za deltaTime sekundi stvarnog vremena (za prozor) i osvezava tajmere flote
+long long advanceEvents(EventScheduler& scheduler, Simulation& sim, double deltaTime, const EventCallbacks* callbacks);
+
+// Upisuje tajmere flote (vreme na segmentu, vreme na stanici) za trenutak sim.time,
+// da bi updateFleetPositions mogao da izracuna pozicije za crtanje
+void syncFleetTimers(const EventScheduler& scheduler, Simulation& sim);
@@ -0,0 +1,160 @@
+#include "Fleet.h"
+#include "Simulation.h"
+#include "Interpolation.h"
+#include "Random.h"
+#include "Profiler.h"
+#include "Bits.h"
+#include <cstring>
+
+void initFleet(Fleet& fleet, int size, const Network& network, unsigned long long seed) {
+    fleet.size = size;
+    fleet.route.assign(size, 0);
+    fleet.routeStop.assign(size, 0);
+    fleet.stationIndex.assign(size, 0);
+    fleet.fromStation.assign(size, 0);
+    fleet.segment.assign(size, 0);
+    fleet.segmentTime.assign(size, 0.0f);
+    fleet.waitTimer.assign(size, 0.0f);
+    fleet.isWaiting.assign(size, 1);
+    fleet.load.assign(size, 0);
+    fleet.pathCursor.assign(size, 0);
+    fleet.pathT.assign(size, 0.0f);
+    fleet.posX.assign(size, 0.0f);
+    fleet.posY.assign(size, 0.0f);
+    fleet.arrivedBuses.assign(size, 0);
+    fleet.departedBuses.assign(size, 0);
+    fleet.arrivedCount = 0;
+    fleet.departedCount = 0;
+
+    for (int i = 0; i < size; ++i) {
+        // Autobusi se dele redom po linijama, a na liniji po stanicama
+        int route = i % network.numRoutes;
+        int base = network.routeOffsets[route];
+        int routeStop = (i / network.numRoutes) % (network.routeOffsets[route + 1] - base);
+        fleet.route[i] = route;
+        fleet.routeStop[i] = routeStop;
+        fleet.stationIndex[i] = network.routeStops[base + routeStop];
+        fleet.fromStation[i] = fleet.stationIndex[i];
+        // Pre prvog polaska autobus je na pocetku segmenta kojim ce krenuti
+        fleet.segment[i] = network.routeSegments[base + routeStop];
+    }
+
+    // Autobus 0 krece kao i ranije (prva stanica, pun period cekanja), ostalima rasporedjujemo
+    // vreme polaska da ne bi svi krenuli u istom trenutku
+    for (int i = 1; i < size; ++i) {
+        RandomStream stream = makeRandomStream(seed, STREAM_BUS, (unsigned int)i);
+        fleet.waitTimer[i] = STATION_WAIT_SECONDS * randomFloat(stream);
+    }
+}
+
+// Polasci i dolasci bloka prepoznaju se po stanju posle koraka (deltaTime > 0): autobus koji je
+// upravo krenuo putuje, a segmentTime mu je tacno 0; autobus koji je upravo stigao stoji, presao je
+// ceo segment, a waitTimer mu je jos 0 (nuliran je pri polasku, a dok autobus stoji samo raste).
+// Oznake se prave vektorizovanom petljom, pa se citaju po 8 autobusa odjednom.
+static void collectFleetEvents(Fleet& fleet, const Network& network, int begin, int count) {
+    const float* segmentTime = fleet.segmentTime.data() + begin;
+    const float* waitTimer = fleet.waitTimer.data() + begin;
+    const int* isWaiting = fleet.isWaiting.data() + begin;
+
+    unsigned char events[FLEET_TICK_BLOCK];   // Bit 0: krenuo, bit 1: stigao
+    for (int i = 0; i < count; ++i) {
+        int departed = (1 - isWaiting[i]) & (segmentTime[i] == 0.0f);
+        int arrived = isWaiting[i] & (waitTimer[i] == 0.0f) & (segmentTime[i] >= TRAVEL_TIME_SECONDS);
+        events[i] = (unsigned char)(departed | (arrived << 1));
+    }
+    int words = (count + 7) / 8;
+    memset(events + count, 0, 8 * words - count);
+
+    for (int word = 0; word < words; ++word) {
+        unsigned long long bits;
+        memcpy(&bits, events + 8 * word, sizeof(bits));
+        for (; bits != 0; bits &= bits - 1) {
+            int bit = countTrailingZeros(bits);
+            int bus = begin + 8 * word + bit / 8;
+            if ((bit & 7) == 0) {
+                departBus(fleet, network, bus);
+                fleet.departedBuses[fleet.departedCount++] = bus;
+            }
+            else {
+                fleet.arrivedBuses[fleet.arrivedCount++] = bus;
+            }
+        }
+    }
+}
+
+int tickFleet(Fleet& fleet, float deltaTime, const Network& network) {
+    const int n = fleet.size;
+    float* segmentTime = fleet.segmentTime.data();
+    float* waitTimer = fleet.waitTimer.data();
+    int* isWaiting = fleet.isWaiting.data();
+
+    // Autobuse obradjujemo u blokovima: tajmeri svih autobusa bloka u jednoj vektorizovanoj petlji
+    // koja pise samo stanje flote i broji polaske i dolaske, a zatim, samo za blok u kome ih je bilo,
+    // polasci (sledeca stanica se cita iz linije, nasumicnim pristupom) i dolasci
+    int arrivals = 0;
+    fleet.arrivedCount = 0;
+    fleet.departedCount = 0;
+    if (deltaTime <= 0.0f)
+        return 0;
+    for (int begin = 0; begin < n; begin += FLEET_TICK_BLOCK) {
+        int count = n - begin < FLEET_TICK_BLOCK ? n - begin : FLEET_TICK_BLOCK;
+        float* blockSegmentTime = segmentTime + begin;
+        float* blockWaitTimer = waitTimer + begin;
+        int* blockIsWaiting = isWaiting + begin;
+
+        // Bez grananja: svaki autobus racuna oba ishoda pa bira, da bi petlja bila vektorizovana
+        int departures = 0;
+        int blockArrivals = 0;
+        for (int i = 0; i < count; ++i) {
+            int waiting = blockIsWaiting[i];
+            float wait = blockWaitTimer[i] + (waiting ? deltaTime : 0.0f);
+            float travel = blockSegmentTime[i] + (waiting ? 0.0f : deltaTime);
+
+            int departs = waiting & (wait >= STATION_WAIT_SECONDS);
+            int arrives = (1 - waiting) & (travel >= TRAVEL_TIME_SECONDS);
+
+            // Mnozenje umesto "departs ? 0.0f : ..." - inace GCC od ovoga pravi grananje i ne vektorizuje petlju
+            float keep = (float)(1 - departs);
+            blockWaitTimer[i] = wait * keep;
+            blockSegmentTime[i] = travel * keep;
+            blockIsWaiting[i] = (waiting & (1 - departs)) | arrives;
+            blockArrivals += arrives;
+            departures += departs;
+        }
+
+        if (departures + blockArrivals != 0)
+            collectFleetEvents(fleet, network, begin, count);
+        arrivals += blockArrivals;
+    }
+    return arrivals;
+}
+
+void departBus(Fleet& fleet, const Network& network, int bus) {
+    int route = fleet.route[bus];
+    int base = network.routeOffsets[route];
+    int from = fleet.routeStop[bus];
+    int next = nextRouteStop(network, route, from);
+
+    fleet.fromStation[bus] = fleet.stationIndex[bus];
+    fleet.segment[bus] = network.routeSegments[base + from];
+    fleet.routeStop[bus] = next;
+    fleet.stationIndex[bus] = network.routeStops[base + next];
+}
+
+void updateFleetPositions(Fleet& fleet, const RoutePath& route) {
+    updateFleetPositions(fleet, route, fleet.posX.data(), fleet.posY.data());
+}
+
+void updateFleetPositions(Fleet& fleet, const RoutePath& route, float* outX, float* outY) {
+    PROFILE_FUNCTION();
+    const int n = fleet.size;
+    int* pathCursor = fleet.pathCursor.data();
+    float* pathT = fleet.pathT.data();
+
+    // Autobus koji stoji je vec presao ceo segment (segmentTime >= TRAVEL_TIME_SECONDS, pa je t = 1),
+    // a pre prvog polaska je na pocetku segmenta kojim ce krenuti (t = 0), pa stajanje nije poseban slucaj
+    advanceRouteCursors(route, fleet.segment.data(), fleet.segmentTime.data(), 1.0f / TRAVEL_TIME_SECONDS,
+        pathCursor, pathT, n);
+
+    interpolateSegments(route.points.data(), pathCursor, nullptr, pathT, 1.0f, outX, outY, n);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+#include "Network.h"
+#include "Route.h"
+
+// Flota autobusa smestena kao paralelni nizovi (structure-of-arrays), da bi petlje koraka
+// simulacije citale samo polja koja im trebaju i da bi ih kompajler vektorizovao
+struct Fleet {
+    int size = 0;
+
+    std::vector<int> route;          // Linija kojom autobus vozi
+    std::vector<int> routeStop;      // Redni broj stanice stationIndex na liniji
+    std::vector<int> stationIndex;   // Odredisna stanica (ili stanica na kojoj autobus stoji)
+    std::vector<int> fromStation;    // Polazna stanica trenutnog segmenta (pamti se pri polasku)
+    std::vector<int> segment;        // Segment mreze kojim autobus vozi (ili je poslednji presao)
+    std::vector<float> segmentTime;  // Vreme provedeno na trenutnom segmentu
+    std::vector<float> waitTimer;    // Vreme provedeno na stanici
+    std::vector<int> isWaiting;      // 1 ako autobus stoji na stanici, 0 ako putuje
+    std::vector<int> load;           // Broj putnika u autobusu
+    std::vector<int> pathCursor;     // Ivica putanje na kojoj je autobus (vidi advanceRouteCursor)
+    std::vector<float> pathT;        // Polozaj na toj ivici (0..1)
+    std::vector<float> posX;         // Pozicija autobusa (x); prozor ih ne azurira, vec pise u bafer flote
+    std::vector<float> posY;         // Pozicija autobusa (y)
+
+    // Autobusi koji su stigli na stanicu, odnosno krenuli sa nje, u poslednjem pozivu tickFleet
+    std::vector<int> arrivedBuses;
+    std::vector<int> departedBuses;
+    int arrivedCount = 0;
+    int departedCount = 0;
+};
+
+// Broj autobusa koje tickFleet obradjuje odjednom (polasci i dolasci se traze samo u bloku u kome ih je bilo)
+const int FLEET_TICK_BLOCK = 256;
+
+// Pravi flotu od size autobusa koji stoje na stanicama, rasporedjenih redom po linijama mreze,
+// sa polascima rasporedjenim pomocu toka slucajnih brojeva svakog autobusa
+void initFleet(Fleet& fleet, int size, const Network& network, unsigned long long seed);
+
+// Pomera sve autobuse za deltaTime sekundi i upisuje koji su stigli i krenuli (arrivedBuses,
+// departedBuses), vraca broj autobusa koji su stigli na stanicu; za deltaTime <= 0 ne radi nista
+int tickFleet(Fleet& fleet, float deltaTime, const Network& network);
+
+// Autobus krece sa stanice na kojoj stoji ka sledecoj stanici svoje linije
+// (menja samo stanice i segment; tajmere postavlja onaj ko poziva)
+void departBus(Fleet& fleet, const Network& network, int bus);
+
+// Racuna pozicije svih autobusa na putanji: autobus prelazi segment izmedju polazne i odredisne
+// stanice konstantnom brzinom duz izlomljene linije (pozicije se racunaju SIMD-om, vidi Interpolation.h)
+void updateFleetPositions(Fleet& fleet, const RoutePath& route);
+
+// Isto, ali pozicije upisuje u outX/outY umesto u posX/posY (prozor ih upisuje pravo u bafer iz
+// koga GPU crta flotu, vidi InstanceStream.h)
+void updateFleetPositions(Fleet& fleet, const RoutePath& route, float* outX, float* outY);
@@ -0,0 +1,192 @@
+#include "GlState.h"
+#include "Metrics.h"
+#include <GL/glew.h>
+
+// Vrednost koja nije ime nijednog GL objekta ni enum: stanje nije poznato
+const unsigned int GL_STATE_UNKNOWN = 0xFFFFFFFFu;
+
+struct GlStateShadow {
+    unsigned int program;
+    unsigned int activeUnit;
+    unsigned int textures[GL_STATE_TEXTURE_UNITS];
+    unsigned int vao;
+    unsigned int arrayBuffer;
+    unsigned int blend;
+    unsigned int blendSource;
+    unsigned int blendDestination;
+};
+
+static const char* const GL_STATE_HELP = "Pozivi za promenu GL stanja, poslati GL-u i preskoceni jer stanje vec vazi";
+static const int ISSUED_METRIC = registerMetric(METRIC_COUNTER, "autobus_gl_state_calls_total", "result=\"issued\"", GL_STATE_HELP);
+static const int ELIDED_METRIC = registerMetric(METRIC_COUNTER, "autobus_gl_state_calls_total", "result=\"elided\"", GL_STATE_HELP);
+static const char* const GL_STATE_FRAME_HELP = "Pozivi za promenu GL stanja u poslednjem frejmu";
+static const int ISSUED_FRAME_METRIC = registerMetric(METRIC_GAUGE, "autobus_gl_state_calls_per_frame", "result=\"issued\"", GL_STATE_FRAME_HELP);
+static const int ELIDED_FRAME_METRIC = registerMetric(METRIC_GAUGE, "autobus_gl_state_calls_per_frame", "result=\"elided\"", GL_STATE_FRAME_HELP);
+static const int DRAWS_METRIC = registerMetric(METRIC_COUNTER, "autobus_gl_draw_calls_total", nullptr, "Pozivi crtanja poslati GL-u");
+static const int DRAWS_FRAME_METRIC = registerMetric(METRIC_GAUGE, "autobus_gl_draw_calls_per_frame", nullptr, "Pozivi crtanja u poslednjem frejmu");
+
+static GlStateShadow shadow;
+static bool shadowValid = false;   // Pre prvog poziva se nista ne zna
+static bool cacheEnabled = true;
+static long long frameIssued = 0;
+static long long frameElided = 0;
+static long long frameDraws = 0;
+static long long lastIssued = 0;
+static long long lastElided = 0;
+static long long lastDraws = 0;
+
+void invalidateGlState() {
+    shadow.program = GL_STATE_UNKNOWN;
+    shadow.activeUnit = GL_STATE_UNKNOWN;
+    for (unsigned int& texture : shadow.textures)
+        texture = GL_STATE_UNKNOWN;
+    shadow.vao = GL_STATE_UNKNOWN;
+    shadow.arrayBuffer = GL_STATE_UNKNOWN;
+    shadow.blend = GL_STATE_UNKNOWN;
+    shadow.blendSource = GL_STATE_UNKNOWN;
+    shadow.blendDestination = GL_STATE_UNKNOWN;
+    shadowValid = true;
+}
+
+// Da li stanje vec ima ovu vrednost; ako nema, pamti je (poziv posle ovoga je salje)
+static bool isCurrent(unsigned int& current, unsigned int value) {
+    if (!shadowValid)
+        invalidateGlState();
+    if (cacheEnabled && current == value) {
+        frameElided++;
+        return true;
+    }
+    current = value;
+    frameIssued++;
+    return false;
+}
+
+void useProgram(unsigned int program) {
+    if (!isCurrent(shadow.program, program))
+        glUseProgram(program);
+}
+
+void activeTextureUnit(int unit) {
+    if (!isCurrent(shadow.activeUnit, (unsigned int)unit))
+        glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void bindTexture2D(unsigned int texture) {
+    if (!shadowValid)
+        invalidateGlState();
+    if (shadow.activeUnit >= (unsigned int)GL_STATE_TEXTURE_UNITS) {
+        frameIssued++;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        return;
+    }
+    if (!isCurrent(shadow.textures[shadow.activeUnit], texture))
+        glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void bindVertexArray(unsigned int vao) {
+    if (!isCurrent(shadow.vao, vao))
+        glBindVertexArray(vao);
+}
+
+void bindArrayBuffer(unsigned int buffer) {
+    if (!isCurrent(shadow.arrayBuffer, buffer))
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+}
+
+void setBlend(bool enabled) {
+    if (isCurrent(shadow.blend, enabled ? 1 : 0))
+        return;
+    if (enabled)
+        glEnable(GL_BLEND);
+    else
+        glDisable(GL_BLEND);
+}
+
+void setBlendFunc(unsigned int source, unsigned int destination) {
+    if (!shadowValid)
+        invalidateGlState();
+    if (cacheEnabled && shadow.blendSource == source && shadow.blendDestination == destination) {
+        frameElided++;
+        return;
+    }
+    shadow.blendSource = source;
+    shadow.blendDestination = destination;
+    frameIssued++;
+    glBlendFunc(source, destination);
+}
+
+void drawArrays(unsigned int mode, int first, int count) {
+    frameDraws++;
+    glDrawArrays(mode, first, count);
+}
+
+void drawArraysInstanced(unsigned int mode, int first, int count, int instances) {
+    frameDraws++;
+    glDrawArraysInstanced(mode, first, count, instances);
+}
+
+void multiDrawArrays(unsigned int mode, const int* first, const int* count, int drawCount) {
+    frameDraws++;
+    glMultiDrawArrays(mode, first, count, drawCount);
+}
+
+// GL odvezuje obrisan objekat sa svih mesta gde je vezan (tekstura sa svih jedinica)
+void deleteTexture(unsigned int texture) {
+    if (texture == 0)
+        return;
+    for (unsigned int& bound : shadow.textures) {
+        if (bound == texture)
+            bound = 0;
+    }
+    glDeleteTextures(1, &texture);
+}
+
+void deleteVertexArray(unsigned int vao) {
+    if (vao == 0)
+        return;
+    if (shadow.vao == vao)
+        shadow.vao = 0;
+    glDeleteVertexArrays(1, &vao);
+}
+
+void deleteBuffer(unsigned int buffer) {
+    if (buffer == 0)
+        return;
+    if (shadow.arrayBuffer == buffer)
+        shadow.arrayBuffer = 0;
+    glDeleteBuffers(1, &buffer);
+}
+
+void setGlStateCache(bool enabled) {
+    cacheEnabled = enabled;
+}
+
+void beginGlStateFrame() {
+    frameIssued = 0;
+    frameElided = 0;
+    frameDraws = 0;
+}
+
+void endGlStateFrame() {
+    addCounter(ISSUED_METRIC, frameIssued);
+    addCounter(ELIDED_METRIC, frameElided);
+    setGauge(ISSUED_FRAME_METRIC, (double)frameIssued);
+    setGauge(ELIDED_FRAME_METRIC, (double)frameElided);
+    addCounter(DRAWS_METRIC, frameDraws);
+    setGauge(DRAWS_FRAME_METRIC, (double)frameDraws);
+    lastIssued = frameIssued;
+    lastElided = frameElided;
+    lastDraws = frameDraws;
+}
+
+long long getGlStateIssued() {
+    return lastIssued;
+}
+
+long long getGlStateElided() {
+    return lastElided;
+}
+
+long long getGlStateDraws() {
+    return lastDraws;
+}
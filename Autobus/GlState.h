@@ -0,0 +1,48 @@
+#pragma once
+
+// Kes GL stanja: pamti aktivni program, aktivnu teksturnu jedinicu, teksture (GL_TEXTURE_2D) po
+// jedinici, VAO, GL_ARRAY_BUFFER i blending, pa poziv koji ne bi nista promenio ne stize do GL-a.
+// Funkcije crtanja zato mogu da postave sve sto im treba (i da ne vracaju stanje na 0 posle
+// crtanja), a GL dobija samo promene. Broje se poslati i preskoceni pozivi po frejmu
+// (autobus_gl_state_calls_total i autobus_gl_state_calls_per_frame, oznaka result=issued/elided).
+// Pozivi crtanja uvek idu do GL-a, ali i oni prolaze kroz ovaj modul, da bi se brojali po frejmu
+// (autobus_gl_draw_calls_total i autobus_gl_draw_calls_per_frame).
+//
+// Radi samo ako sav kod vezuje ove objekte preko kesa. Posle koda koji menja stanje direktno
+// (npr. biblioteka) treba pozvati invalidateGlState; objekti se brisu preko delete* ispod, jer GL
+// odvezuje obrisan objekat, a njegovo ime moze da dobije novi objekat.
+
+// Teksturne jedinice koje se pamte; vise jedinice se uvek salju GL-u
+const int GL_STATE_TEXTURE_UNITS = 16;
+
+void useProgram(unsigned int program);
+void activeTextureUnit(int unit);            // Broj jedinice (0 za GL_TEXTURE0)
+void bindTexture2D(unsigned int texture);    // Na aktivnoj jedinici
+void bindVertexArray(unsigned int vao);
+void bindArrayBuffer(unsigned int buffer);
+void setBlend(bool enabled);
+void setBlendFunc(unsigned int source, unsigned int destination);
+
+// Crtanje; glMultiDrawArrays je jedan poziv bez obzira na broj lista
+void drawArrays(unsigned int mode, int first, int count);
+void drawArraysInstanced(unsigned int mode, int first, int count, int instances);
+void multiDrawArrays(unsigned int mode, const int* first, const int* count, int drawCount);
+
+void deleteTexture(unsigned int texture);
+void deleteVertexArray(unsigned int vao);
+void deleteBuffer(unsigned int buffer);
+
+// Zaboravlja sve zapamceno stanje (sledeci poziv svake vrste se salje GL-u)
+void invalidateGlState();
+
+// enabled = false: svaki poziv se salje (za poredjenje, --no-state-cache)
+void setGlStateCache(bool enabled);
+
+// Granice frejma za brojace: begin ih nulira, end ih upisuje u metrike i pamti kao poslednji frejm
+void beginGlStateFrame();
+void endGlStateFrame();
+
+// Poslati i preskoceni pozivi i pozivi crtanja u poslednjem zavrsenom frejmu
+long long getGlStateIssued();
+long long getGlStateElided();
+long long getGlStateDraws();
@@ -0,0 +1,129 @@
+#include "GpuTimer.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include <GL/glew.h>
+
+static const char* const GPU_PASS_NAMES[GPU_PASS_COUNT] = { "gpu path", "gpu stations", "gpu bus", "gpu hud" };
+
+static const char* GPU_DRAW_HELP = "Trajanje dela crtanja na GPU-u (GL_TIME_ELAPSED)";
+static const int GPU_PASS_METRICS[GPU_PASS_COUNT] = {
+    registerMetric(METRIC_HISTOGRAM, "autobus_gpu_draw_seconds", "pass=\"path\"", GPU_DRAW_HELP, 1e-9),
+    registerMetric(METRIC_HISTOGRAM, "autobus_gpu_draw_seconds", "pass=\"stations\"", GPU_DRAW_HELP, 1e-9),
+    registerMetric(METRIC_HISTOGRAM, "autobus_gpu_draw_seconds", "pass=\"bus\"", GPU_DRAW_HELP, 1e-9),
+    registerMetric(METRIC_HISTOGRAM, "autobus_gpu_draw_seconds", "pass=\"hud\"", GPU_DRAW_HELP, 1e-9)
+};
+static const int GPU_DROPPED_METRIC = registerMetric(METRIC_COUNTER, "autobus_gpu_timers_dropped_total", nullptr,
+    "GPU merenja odbacena jer rezultat nije stigao za GPU_TIMER_FRAMES frejmova");
+
+// Upiti jednog frejma; pending: upit je poslat, a rezultat jos nije procitan
+struct GpuTimerFrame {
+    GLuint queries[GPU_PASS_COUNT];
+    bool pending[GPU_PASS_COUNT];
+    unsigned long long cpuStart[GPU_PASS_COUNT];   // Vreme profajlera kada je deo poslat
+    int profileFrame;
+};
+
+static bool timersEnabled = false;
+static GpuTimerFrame timerFrames[GPU_TIMER_FRAMES];
+static int currentFrame = 0;
+static int activePass = -1;
+static double lastSeconds[GPU_PASS_COUNT];
+static long long droppedTimers = 0;
+
+bool initGpuTimers() {
+    if (!GLEW_VERSION_3_3 && !GLEW_ARB_timer_query)
+        return false;
+    for (GpuTimerFrame& frame : timerFrames) {
+        glGenQueries(GPU_PASS_COUNT, frame.queries);
+        for (int p = 0; p < GPU_PASS_COUNT; ++p)
+            frame.pending[p] = false;
+        frame.profileFrame = 0;
+    }
+    for (int p = 0; p < GPU_PASS_COUNT; ++p)
+        lastSeconds[p] = -1.0;
+    currentFrame = 0;
+    activePass = -1;
+    droppedTimers = 0;
+    timersEnabled = true;
+    return true;
+}
+
+void destroyGpuTimers() {
+    if (!timersEnabled)
+        return;
+    for (GpuTimerFrame& frame : timerFrames)
+        glDeleteQueries(GPU_PASS_COUNT, frame.queries);
+    timersEnabled = false;
+}
+
+void collectGpuTimers() {
+    if (!timersEnabled)
+        return;
+    for (GpuTimerFrame& frame : timerFrames) {
+        for (int p = 0; p < GPU_PASS_COUNT; ++p) {
+            if (!frame.pending[p] || (&frame == &timerFrames[currentFrame] && p == activePass))
+                continue;
+            GLint available = 0;
+            glGetQueryObjectiv(frame.queries[p], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                continue;
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(frame.queries[p], GL_QUERY_RESULT, &nanoseconds);
+            frame.pending[p] = false;
+            lastSeconds[p] = nanoseconds * 1e-9;
+            recordHistogram(GPU_PASS_METRICS[p], nanoseconds);
+#ifdef AUTOBUS_PROFILE
+            recordProfileGpuEvent(GPU_PASS_NAMES[p], frame.cpuStart[p], nanoseconds, frame.profileFrame);
+#endif
+        }
+    }
+}
+
+void beginGpuFrame() {
+    if (!timersEnabled)
+        return;
+    collectGpuTimers();
+    currentFrame = (currentFrame + 1) % GPU_TIMER_FRAMES;
+
+    // Rezultat koji nije stigao za GPU_TIMER_FRAMES frejmova se odbacuje, jer se upit ponovo koristi
+    GpuTimerFrame& frame = timerFrames[currentFrame];
+    for (int p = 0; p < GPU_PASS_COUNT; ++p) {
+        if (frame.pending[p]) {
+            frame.pending[p] = false;
+            droppedTimers++;
+            addCounter(GPU_DROPPED_METRIC, 1);
+        }
+    }
+#ifdef AUTOBUS_PROFILE
+    frame.profileFrame = getProfileFrame();
+#endif
+}
+
+void beginGpuTimer(int pass) {
+    if (!timersEnabled || activePass >= 0)
+        return;
+    GpuTimerFrame& frame = timerFrames[currentFrame];
+    if (frame.pending[pass])
+        return;
+#ifdef AUTOBUS_PROFILE
+    frame.cpuStart[pass] = getProfileClock();
+#endif
+    glBeginQuery(GL_TIME_ELAPSED, frame.queries[pass]);
+    frame.pending[pass] = true;
+    activePass = pass;
+}
+
+void endGpuTimer() {
+    if (activePass < 0)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    activePass = -1;
+}
+
+double getGpuTimerSeconds(int pass) {
+    return lastSeconds[pass];
+}
+
+long long getDroppedGpuTimers() {
+    return droppedTimers;
+}
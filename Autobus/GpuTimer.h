@@ -0,0 +1,39 @@
+#pragma once
+
+// Trajanje delova crtanja na GPU-u (GL_TIME_ELAPSED upiti). Vreme na procesoru (autobus_draw_seconds)
+// meri samo slanje naredbi, jer GL radi asinhrono; ovde se meri izvrsavanje. Svaki deo ima
+// GPU_TIMER_FRAMES upita u krug: rezultat frejma se cita tek kada je dostupan (obicno nekoliko
+// frejmova kasnije), pa citanje nikad ne ceka GPU. Rezultati idu u histograme
+// autobus_gpu_draw_seconds{pass=...} i, sa AUTOBUS_PROFILE, u traku "GPU" profila.
+//
+// Radi i sa softverskim crtanjem (Mesa llvmpipe), ali tamo upit meri samo pripremu naredbi: llvmpipe
+// iscrtava tek pri glFlush/glFinish, posle kraja upita.
+
+enum GpuPass {
+    GPU_PASS_PATH,
+    GPU_PASS_STATIONS,
+    GPU_PASS_BUS,       // Svi autobusi zajedno (upiti ne mogu da se ugnezde, pa ne po autobusu)
+    GPU_PASS_HUD,       // Ikone i ime (jedan poziv, SpriteBatch.h)
+    GPU_PASS_COUNT
+};
+
+// Broj frejmova u krugu upita; rezultat stariji od toga se odbacuje
+const int GPU_TIMER_FRAMES = 4;
+
+// Pravi upite (posle glewInit); vraca false ako GL nema timer upite, i tada merenje ne radi nista
+bool initGpuTimers();
+void destroyGpuTimers();
+
+// Pocetak frejma: cita sve dostupne rezultate i prelazi na sledeci skup upita u krugu
+void beginGpuFrame();
+
+// Meri naredbe izmedju poziva; delovi se ne smeju preklapati
+void beginGpuTimer(int pass);
+void endGpuTimer();
+
+// Cita dostupne rezultate bez prelaska na sledeci frejm (npr. posle glFinish)
+void collectGpuTimers();
+
+// Poslednji procitan rezultat dela u sekundama (-1 ako ga jos nema) i broj odbacenih rezultata
+double getGpuTimerSeconds(int pass);
+long long getDroppedGpuTimers();
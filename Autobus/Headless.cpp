@@ -0,0 +1,213 @@
+#include "Headless.h"
+#include "Simulation.h"
+#include "Options.h"
+#include "EventScheduler.h"
+#include "Snapshot.h"
+#include "InputLog.h"
+#include "Logger.h"
+#include "Telemetry.h"
+#include "Metrics.h"
+#include <iostream>
+#include <chrono>
+
+// Jedan radni dan simuliranog vremena
+const double DEFAULT_DURATION_SECONDS = 24.0 * 60.0 * 60.0;
+
+int runHeadless(int argc, char** argv) {
+    double duration = getArgumentDouble(argc, argv, "--duration", DEFAULT_DURATION_SECONDS);
+    float step = (float)getArgumentDouble(argc, argv, "--step", SIMULATION_STEP_SECONDS);
+    if (duration <= 0.0 || step <= 0.0f) {
+        std::cerr << "Neispravno trajanje ili korak simulacije." << std::endl;
+        return -1;
+    }
+
+    // --events: skace se od dogadjaja do dogadjaja umesto koraka fiksne duzine
+    bool eventDriven = hasArgument(argc, argv, "--events");
+    EventScheduler scheduler;
+
+    // --load-snapshot: nastavlja se snimljena simulacija (vidi Snapshot.h), umesto nove
+    Simulation sim;
+    const char* loadPath = getArgument(argc, argv, "--load-snapshot", nullptr);
+    if (loadPath != nullptr) {
+        auto loadStart = std::chrono::steady_clock::now();
+        if (!loadSnapshot(loadPath, sim, eventDriven ? &scheduler : nullptr))
+            return -1;
+        std::cout << "Ucitavanje snimka: " << std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count() * 1000.0
+            << " ms" << std::endl;
+    }
+    else {
+        SimulationConfig config;
+        Network network;
+        if (!getSimulationConfig(argc, argv, config) || !getNetworkArgument(argc, argv, network))
+            return -1;
+        initSimulation(sim, network, config);
+        if (eventDriven)
+            initEventScheduler(scheduler, sim);
+    }
+
+    // --telemetry: stanje flote u pravilnim razmacima (--telemetry-interval, vidi Telemetry.h)
+    const char* telemetryPath = getArgument(argc, argv, "--telemetry", nullptr);
+    double telemetryInterval = getArgumentDouble(argc, argv, "--telemetry-interval", TELEMETRY_INTERVAL_SECONDS);
+    if (telemetryPath != nullptr && (telemetryInterval <= 0.0 || !startTelemetry(telemetryPath, sim.fleet.size, telemetryInterval, true)))
+        return -1;
+
+    // --log: dogadjaji idu u binarni dnevnik (citljiv ispis: --format-log)
+    const char* logPath = getArgument(argc, argv, "--log", nullptr);
+    if (logPath != nullptr && !startLog(logPath)) {
+        stopTelemetry();
+        return -1;
+    }
+
+    // --metrics-port: metrike su dostupne preko HTTP-a dok simulacija radi
+    int metricsPort = (int)getArgumentInt(argc, argv, "--metrics-port", 0);
+    if (metricsPort > 0 && !startMetricsServer(metricsPort)) {
+        stopLog();
+        stopTelemetry();
+        return -1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (eventDriven) {
+        double endTime = sim.time + duration;
+        if (telemetryPath != nullptr) {
+            // Dogadjaji idu do vremena svakog uzorka, pa se tajmeri flote osveze za uzorak
+            recordTelemetry(sim);
+            while (sim.time < endTime) {
+                double next = getNextTelemetryTime();
+                runEventsUntil(scheduler, sim, next < endTime ? next : endTime, nullptr);
+                syncFleetTimers(scheduler, sim);
+                recordTelemetry(sim);
+            }
+        }
+        else
+            runEventsUntil(scheduler, sim, endTime, nullptr);
+    }
+    else {
+        long long totalSteps = (long long)(duration / step + 0.5);
+        recordTelemetry(sim);
+        for (long long i = 0; i < totalSteps; ++i) {
+            stepSimulation(sim, step);
+            recordTelemetry(sim);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double wallSeconds = std::chrono::duration<double>(end - start).count();
+    if (telemetryPath != nullptr) {
+        stopTelemetry();
+        TelemetryStats stats = getTelemetryStats();
+        std::cout << "Telemetrija: " << stats.samples << " uzoraka (" << stats.droppedSamples << " odbaceno), "
+            << stats.bytes / (1024.0 * 1024.0) << " MB, memorija " << stats.memoryBytes / (1024.0 * 1024.0) << " MB" << std::endl;
+    }
+    if (logPath != nullptr) {
+        stopLog();
+        std::cout << "Dnevnik: " << getLoggedCount() << " zapisa, " << getDroppedLogCount() << " odbaceno" << std::endl;
+    }
+
+    if (eventDriven)
+        std::cout << "Simulirano vreme: " << sim.time << " s (" << scheduler.processedEvents << " dogadjaja)" << std::endl;
+    else
+        std::cout << "Simulirano vreme: " << sim.time << " s (" << sim.tickCount << " koraka)" << std::endl;
+    std::cout << "Broj dolazaka na stanice: " << sim.arrivalsCount << std::endl;
+    std::cout << "Broj autobusa: " << sim.fleet.size << std::endl;
+    std::cout << "Broj putnika: " << getPassengersNumber(sim) << std::endl;
+
+    const Passengers& passengers = sim.passengers;
+    std::cout << "Putnici: " << passengers.spawnedCount << " pojavljenih (" << passengers.droppedCount
+        << " odbaceno, nije bilo mesta), " << passengers.boardedCount << " uslo, " << passengers.alightedCount
+        << " izaslo, " << passengers.count << " jos u sistemu" << std::endl;
+    const Inspectors& inspectors = sim.inspectors;
+    if (inspectors.count > 0)
+        std::cout << "Kontrolori: " << inspectors.count << ", " << inspectors.inspectionsCount << " kontrola, "
+            << inspectors.finedCount << " kaznjenih, " << inspectors.transfersCount << " presedanja" << std::endl;
+    if (!eventDriven && sim.tickCount > 0)
+        std::cout << "Ulazaka po koraku: prosecno " << (double)passengers.boardedCount / sim.tickCount
+            << ", najvise " << sim.maxTickBoardings << std::endl;
+    int tickMetric = findMetric("autobus_tick_seconds", nullptr);
+    if (!eventDriven && getHistogramCount(tickMetric) > 0)
+        std::cout << "Trajanje koraka: p50 " << getHistogramPercentile(tickMetric, 50.0) * 1e6 << " us, p99 "
+            << getHistogramPercentile(tickMetric, 99.0) * 1e6 << " us, p99.9 " << getHistogramPercentile(tickMetric, 99.9) * 1e6
+            << " us" << std::endl;
+    if (wallSeconds > 0.0)
+        std::cout << "Ulazaka u sekundi stvarnog vremena: " << passengers.boardedCount / wallSeconds << std::endl;
+    std::cout << "Stvarno vreme: " << wallSeconds << " s";
+    if (wallSeconds > 0.0)
+        std::cout << " (" << sim.time / wallSeconds << "x brze od realnog vremena)";
+    std::cout << std::endl;
+
+    // --metrics: metrike na kraju rada u tekstualnom formatu Prometheus-a
+    updateSimulationMetrics(sim);
+    stopMetricsServer();
+    const char* metricsPath = getArgument(argc, argv, "--metrics", nullptr);
+    if (metricsPath != nullptr && !dumpMetrics(metricsPath))
+        return -1;
+
+    // --save-snapshot: stanje na kraju rada, da bi se simulacija mogla nastaviti
+    const char* savePath = getArgument(argc, argv, "--save-snapshot", nullptr);
+    if (savePath != nullptr) {
+        if (eventDriven)
+            syncFleetTimers(scheduler, sim);
+        auto saveStart = std::chrono::steady_clock::now();
+        if (!saveSnapshot(savePath, sim, eventDriven ? &scheduler : nullptr))
+            return -1;
+        std::cout << "Upis snimka: " << std::chrono::duration<double>(std::chrono::steady_clock::now() - saveStart).count() * 1000.0
+            << " ms" << std::endl;
+    }
+    return 0;
+}
+
+int runReplay(int argc, char** argv) {
+    const char* path = getArgument(argc, argv, "--replay", nullptr);
+    InputLog log;
+    if (path == nullptr || !loadInputLog(log, path))
+        return -1;
+
+    // Pocetno stanje kao u snimljenoj sesiji
+    Simulation sim;
+    EventScheduler scheduler;
+    EventScheduler* events = log.eventDriven ? &scheduler : nullptr;
+    if (log.source == INPUT_SOURCE_SNAPSHOT) {
+        if (!loadSnapshot(log.sourcePath.c_str(), sim, events))
+            return -1;
+    }
+    else {
+        Network network;
+        if (log.sourcePath.empty())
+            makeLoopNetwork(network, NUM_STATIONS, ROUTE_AXIS_A, ROUTE_AXIS_B);
+        else if (!loadNetwork(network, log.sourcePath.c_str()))
+            return -1;
+        initSimulation(sim, network, log.config);
+        if (events)
+            initEventScheduler(scheduler, sim);
+    }
+
+    // Simulacija ide do vremena svakog ulaza pa ga izvrsava, bez cekanja
+    long long applied = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < log.records.size(); ++i) {
+        const InputRecord& record = log.records[i];
+        if (events)
+            runEventsUntil(scheduler, sim, record.time * EVENT_TICK_SECONDS, nullptr);
+        else {
+            while ((unsigned long long)sim.tickCount < record.time)
+                stepSimulation(sim, SIMULATION_STEP_SECONDS);
+        }
+        if (record.type != INPUT_END && applyInput(sim, record.type))
+            applied++;
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    InputLogTotals totals = getInputLogTotals(sim);
+    const InputLogTotals& expected = log.totals;
+    bool same = totals.playerPassengers == expected.playerPassengers && totals.boardedCount == expected.boardedCount
+        && totals.alightedCount == expected.alightedCount && totals.finedCount == expected.finedCount
+        && totals.inspectionsCount == expected.inspectionsCount;
+
+    std::cout << "Ponovljeno ulaza: " << log.records.size() - 1 << " (" << applied << " sa efektom), simulirano vreme: "
+        << sim.time << " s, stvarno vreme: " << wallSeconds << " s" << std::endl;
+    std::cout << "Putnika u autobusu: " << totals.playerPassengers << " (snimljeno " << expected.playerPassengers
+        << "), uslo: " << totals.boardedCount << " (" << expected.boardedCount << "), izaslo: " << totals.alightedCount
+        << " (" << expected.alightedCount << "), kaznjeno: " << totals.finedCount << " (" << expected.finedCount
+        << "), kontrola: " << totals.inspectionsCount << " (" << expected.inspectionsCount << ")" << std::endl;
+    std::cout << (same ? "Ishod je isti kao u snimljenoj sesiji." : "Ishod se RAZLIKUJE od snimljene sesije!") << std::endl;
+    return same ? 0 : -1;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Pokrece simulaciju bez prozora (--headless), najbrze sto procesor moze, i ispisuje rezime
+// Opcije: --duration <sekunde> (podrazumevano jedan radni dan), --step <sekunde>, --buses <broj>,
+//        --events (simulacija vodjena dogadjajima umesto fiksnih koraka), --seed <broj>,
+//        --network <fajl> (mreza stanica i linija, vidi Network.h),
+//        --passengers <broj> (najvise putnika u isto vreme), --demand <putnika u sekundi po stanici linije>,
+//        --inspectors <broj>, --inspector-policy next|loaded|random (vidi Inspectors.h),
+//        --load-snapshot <fajl>, --save-snapshot <fajl> (vidi Snapshot.h), --log <fajl> (vidi Logger.h),
+//        --telemetry <fajl>, --telemetry-interval <sekunde> (vidi Telemetry.h),
+//        --metrics <fajl>, --metrics-port <port> (vidi Metrics.h)
+int runHeadless(int argc, char** argv);
+
+// Ponavlja sesiju snimljenu u prozoru (--replay <fajl>, vidi InputLog.h) najvecom brzinom i poredi
+// ishod sa snimljenim; vraca -1 ako se razlikuje
+int runReplay(int argc, char** argv);
@@ -0,0 +1,186 @@
+#include "InputLog.h"
+#include "EventScheduler.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+static const char INPUT_LOG_MAGIC[8] = { 'A', 'U', 'T', 'O', 'I', 'N', 'P', 'T' };
+
+// Zaglavlje u fajlu; iza njega je putanja izvora (sourceLength bajtova)
+struct InputLogFileHeader {
+    char magic[8];
+    unsigned int version;
+    unsigned int eventDriven;
+    unsigned int source;
+    unsigned int sourceLength;
+    int numBuses;
+    int passengerCapacity;
+    double demand;
+    int numInspectors;
+    int transferPolicy;
+    unsigned long long seed;
+};
+
+static void writeVarint(FILE* file, unsigned long long value) {
+    unsigned char bytes[10];
+    int count = 0;
+    while (value >= 0x80) {
+        bytes[count++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[count++] = (unsigned char)value;
+    fwrite(bytes, 1, count, file);
+}
+
+static bool readVarint(FILE* file, unsigned long long& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = fgetc(file);
+        if (byte == EOF)
+            return false;
+        value |= (unsigned long long)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+// Vreme ulaza: korak, ili poslednji obradjeni tik dogadjaja (isto zaokruzivanje kao u runEventsUntil)
+static unsigned long long getInputTime(const InputRecorder& recorder, const Simulation& sim) {
+    if (recorder.eventDriven)
+        return (unsigned long long)floor(sim.time / EVENT_TICK_SECONDS + 1e-6);
+    return (unsigned long long)sim.tickCount;
+}
+
+bool startInputRecording(InputRecorder& recorder, const char* path, const InputLog& header) {
+    recorder = InputRecorder();
+    recorder.file = fopen(path, "wb");
+    if (recorder.file == nullptr) {
+        std::cerr << "Greska pri otvaranju fajla za snimanje ulaza \"" << path << "\"!" << std::endl;
+        return false;
+    }
+    recorder.eventDriven = header.eventDriven;
+
+    InputLogFileHeader fileHeader;
+    memset(&fileHeader, 0, sizeof(fileHeader));
+    memcpy(fileHeader.magic, INPUT_LOG_MAGIC, sizeof(fileHeader.magic));
+    fileHeader.version = INPUT_LOG_VERSION;
+    fileHeader.eventDriven = header.eventDriven ? 1 : 0;
+    fileHeader.source = (unsigned int)header.source;
+    fileHeader.sourceLength = (unsigned int)header.sourcePath.size();
+    fileHeader.numBuses = header.config.numBuses;
+    fileHeader.passengerCapacity = header.config.passengerCapacity;
+    fileHeader.demand = header.config.demand;
+    fileHeader.numInspectors = header.config.numInspectors;
+    fileHeader.transferPolicy = header.config.transferPolicy;
+    fileHeader.seed = header.config.seed;
+    fwrite(&fileHeader, sizeof(fileHeader), 1, recorder.file);
+    fwrite(header.sourcePath.data(), 1, header.sourcePath.size(), recorder.file);
+    std::cout << "Snimanje ulaza u \"" << path << "\"" << std::endl;
+    return true;
+}
+
+void recordInput(InputRecorder& recorder, const Simulation& sim, int type) {
+    if (recorder.file == nullptr)
+        return;
+    unsigned long long time = getInputTime(recorder, sim);
+    writeVarint(recorder.file, ((time - recorder.lastTime) << 2) | (unsigned long long)type);
+    recorder.lastTime = time;
+    recorder.recordCount++;
+}
+
+void finishInputRecording(InputRecorder& recorder, const Simulation& sim) {
+    if (recorder.file == nullptr)
+        return;
+    recordInput(recorder, sim, INPUT_END);
+
+    InputLogTotals totals = getInputLogTotals(sim);
+    writeVarint(recorder.file, (unsigned long long)totals.playerPassengers);
+    writeVarint(recorder.file, (unsigned long long)totals.boardedCount);
+    writeVarint(recorder.file, (unsigned long long)totals.alightedCount);
+    writeVarint(recorder.file, (unsigned long long)totals.finedCount);
+    writeVarint(recorder.file, (unsigned long long)totals.inspectionsCount);
+    fclose(recorder.file);
+    std::cout << "Snimljeno ulaza: " << recorder.recordCount - 1 << std::endl;
+    recorder.file = nullptr;
+}
+
+static bool readTotal(FILE* file, long long& value) {
+    unsigned long long raw = 0;
+    bool valid = readVarint(file, raw);
+    value = (long long)raw;
+    return valid;
+}
+
+bool loadInputLog(InputLog& log, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        std::cerr << "Greska pri citanju snimka ulaza sa putanje \"" << path << "\"!" << std::endl;
+        return false;
+    }
+
+    log = InputLog();
+    InputLogFileHeader fileHeader;
+    bool valid = fread(&fileHeader, sizeof(fileHeader), 1, file) == 1
+        && memcmp(fileHeader.magic, INPUT_LOG_MAGIC, sizeof(fileHeader.magic)) == 0
+        && fileHeader.version == INPUT_LOG_VERSION;
+    if (valid) {
+        log.eventDriven = fileHeader.eventDriven != 0;
+        log.source = (int)fileHeader.source;
+        log.config.numBuses = fileHeader.numBuses;
+        log.config.passengerCapacity = fileHeader.passengerCapacity;
+        log.config.demand = fileHeader.demand;
+        log.config.numInspectors = fileHeader.numInspectors;
+        log.config.transferPolicy = fileHeader.transferPolicy;
+        log.config.seed = fileHeader.seed;
+        log.sourcePath.resize(fileHeader.sourceLength);
+        valid = fileHeader.sourceLength == 0
+            || fread(&log.sourcePath[0], 1, fileHeader.sourceLength, file) == fileHeader.sourceLength;
+    }
+
+    // Zapisi do INPUT_END, pa brojaci
+    unsigned long long time = 0;
+    bool ended = false;
+    while (valid && !ended) {
+        unsigned long long value = 0;
+        valid = readVarint(file, value);
+        InputRecord record;
+        time += value >> 2;
+        record.time = time;
+        record.type = (int)(value & 3);
+        log.records.push_back(record);
+        ended = record.type == INPUT_END;
+    }
+    valid = valid && readTotal(file, log.totals.playerPassengers) && readTotal(file, log.totals.boardedCount)
+        && readTotal(file, log.totals.alightedCount) && readTotal(file, log.totals.finedCount)
+        && readTotal(file, log.totals.inspectionsCount);
+    fclose(file);
+
+    if (!valid) {
+        std::cerr << "Fajl \"" << path << "\" nije ispravan snimak ulaza." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool applyInput(Simulation& sim, int type) {
+    switch (type) {
+    case INPUT_CONTROL:
+        return startControl(sim);
+    case INPUT_ADD_PASSENGER:
+        return addPassenger(sim);
+    case INPUT_REMOVE_PASSENGER:
+        return removePassenger(sim);
+    }
+    return false;
+}
+
+InputLogTotals getInputLogTotals(const Simulation& sim) {
+    InputLogTotals totals;
+    totals.playerPassengers = getPassengersNumber(sim);
+    totals.boardedCount = sim.passengers.boardedCount;
+    totals.alightedCount = sim.passengers.alightedCount;
+    totals.finedCount = sim.passengers.finedCount;
+    totals.inspectionsCount = sim.inspectors.inspectionsCount;
+    return totals;
+}
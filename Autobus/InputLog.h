@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+
+// Snimanje ulaza korisnika (taster K, levi i desni klik) sa simuliranim vremenom, da bi se sesija
+// iz prozora ponovila bez prozora (--replay), najvecom brzinom i sa istim ishodom.
+//
+// Fajl je zaglavlje (parametri simulacije i izvor: mreza ili snimak stanja) pa zapisi. Zapis je
+// jedan varint: (razlika vremena od prethodnog zapisa << 2) | vrsta ulaza, obicno jedan ili dva
+// bajta. Vreme je redni broj koraka (fiksni koraci) ili tik dogadjaja (--events, EVENT_TICK_SECONDS).
+// Poslednji zapis je INPUT_END sa vremenom kraja sesije, a iza njega su brojaci na kraju sesije
+// (vidi InputLogTotals), sa kojima ponavljanje poredi svoj ishod.
+
+enum InputType {
+    INPUT_CONTROL,           // Taster K: kontrolor ulazi u autobus
+    INPUT_ADD_PASSENGER,     // Levi klik: putnik ulazi
+    INPUT_REMOVE_PASSENGER,  // Desni klik: putnik izlazi
+    INPUT_END                // Kraj sesije
+};
+
+const unsigned int INPUT_LOG_VERSION = 1;
+
+// Izvor pocetnog stanja sesije
+enum InputSource {
+    INPUT_SOURCE_NETWORK,    // Nova simulacija na mrezi iz fajla (prazna putanja: podrazumevana linija)
+    INPUT_SOURCE_SNAPSHOT    // Simulacija ucitana iz snimka stanja (vidi Snapshot.h)
+};
+
+// Brojaci na kraju sesije
+struct InputLogTotals {
+    long long playerPassengers = 0;
+    long long boardedCount = 0;
+    long long alightedCount = 0;
+    long long finedCount = 0;
+    long long inspectionsCount = 0;
+};
+
+struct InputRecord {
+    unsigned long long time;  // Korak ili tik dogadjaja
+    int type;
+};
+
+struct InputLog {
+    SimulationConfig config;
+    bool eventDriven = false;
+    int source = INPUT_SOURCE_NETWORK;
+    std::string sourcePath;
+    std::vector<InputRecord> records;  // Poslednji je INPUT_END
+    InputLogTotals totals;
+};
+
+struct InputRecorder {
+    FILE* file = nullptr;
+    bool eventDriven = false;
+    unsigned long long lastTime = 0;
+    long long recordCount = 0;
+};
+
+// Otvara fajl i upisuje zaglavlje; vraca false (i ispisuje gresku) ako fajl ne moze da se otvori
+bool startInputRecording(InputRecorder& recorder, const char* path, const InputLog& header);
+
+// Upisuje ulaz u trenutku sim.time (korak sim.tickCount kod fiksnih koraka)
+void recordInput(InputRecorder& recorder, const Simulation& sim, int type);
+
+// Upisuje INPUT_END i brojace sesije i zatvara fajl
+void finishInputRecording(InputRecorder& recorder, const Simulation& sim);
+
+// Ucitava ceo snimak ulaza; vraca false (i ispisuje gresku) ako fajl nije ispravan
+bool loadInputLog(InputLog& log, const char* path);
+
+// Izvrsava ulaz nad simulacijom (kao u prozoru), vraca false ako ulaz nije imao efekta
+bool applyInput(Simulation& sim, int type);
+
+// Brojaci simulacije koji se porede pri ponavljanju
+InputLogTotals getInputLogTotals(const Simulation& sim);
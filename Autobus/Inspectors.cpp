@@ -0,0 +1,120 @@
+#include "Inspectors.h"
+#include "Random.h"
+#include <cstring>
+
+void initInspectors(Inspectors& inspectors, int numInspectors, int policy, int numBuses, int numStops,
+    unsigned long long seed) {
+    inspectors = Inspectors();
+    inspectors.count = numInspectors;
+    inspectors.policy = policy;
+    inspectors.seed = seed;
+
+    int total = numInspectors + 1;
+    inspectors.bus.assign(total, -1);
+    inspectors.stop.assign(total, -1);
+    inspectors.lastBus.assign(total, -1);
+    inspectors.skipped.assign(total, 0);
+    inspectors.nextWaiting.assign(total, -1);
+    inspectors.draws.assign(total, 0);
+    inspectors.busInspector.assign(numBuses, -1);
+    inspectors.waitingHead.assign(numStops, -1);
+
+    // Prvi broj iz toka kontrolora bira stanicu na kojoj pocinje
+    for (int i = 1; i < total; ++i) {
+        RandomStream stream = makeRandomStream(seed, STREAM_INSPECTION, (unsigned int)i);
+        int stop = randomInt(stream, numStops);
+        inspectors.draws[i] = (unsigned int)stream.counter;
+        inspectors.stop[i] = stop;
+        inspectors.nextWaiting[i] = inspectors.waitingHead[stop];
+        inspectors.waitingHead[stop] = i;
+    }
+}
+
+int parseTransferPolicy(const char* name) {
+    if (strcmp(name, "next") == 0)
+        return TRANSFER_NEXT_BUS;
+    if (strcmp(name, "loaded") == 0)
+        return TRANSFER_LOADED_BUS;
+    if (strcmp(name, "random") == 0)
+        return TRANSFER_RANDOM_BUS;
+    return -1;
+}
+
+bool boardInspector(Inspectors& inspectors, int inspector, int bus) {
+    if (inspectors.busInspector[bus] >= 0 || inspectors.bus[inspector] >= 0)
+        return false;
+    inspectors.bus[inspector] = bus;
+    inspectors.busInspector[bus] = inspector;
+    return true;
+}
+
+// Da li kontrolor koji ceka ulazi u autobus koji polazi
+static bool acceptsBus(Inspectors& inspectors, const Fleet& fleet, int inspector, int bus) {
+    if (inspectors.skipped[inspector] >= INSPECTOR_MAX_SKIPPED)
+        return true;
+
+    bool accepts = true;
+    if (bus == inspectors.lastBus[inspector])
+        accepts = false;
+    else if (inspectors.policy == TRANSFER_LOADED_BUS)
+        accepts = fleet.load[bus] >= INSPECTOR_MIN_LOAD;
+    else if (inspectors.policy == TRANSFER_RANDOM_BUS) {
+        RandomStream stream = makeRandomStream(inspectors.seed, STREAM_INSPECTION, (unsigned int)inspector);
+        stream.counter = inspectors.draws[inspector];
+        accepts = randomFloat(stream) < 0.5f;
+        inspectors.draws[inspector] = (unsigned int)stream.counter;
+    }
+    if (!accepts)
+        inspectors.skipped[inspector]++;
+    return accepts;
+}
+
+int boardWaitingInspector(Inspectors& inspectors, const Fleet& fleet, int bus) {
+    if (inspectors.busInspector[bus] >= 0)
+        return -1;
+
+    int station = fleet.fromStation[bus];
+    int previous = -1;
+    for (int inspector = inspectors.waitingHead[station]; inspector >= 0; inspector = inspectors.nextWaiting[inspector]) {
+        if (!acceptsBus(inspectors, fleet, inspector, bus)) {
+            previous = inspector;
+            continue;
+        }
+
+        // Izlazi iz liste stanice
+        if (previous < 0)
+            inspectors.waitingHead[station] = inspectors.nextWaiting[inspector];
+        else
+            inspectors.nextWaiting[previous] = inspectors.nextWaiting[inspector];
+        inspectors.nextWaiting[inspector] = -1;
+        inspectors.stop[inspector] = -1;
+        inspectors.skipped[inspector] = 0;
+
+        boardInspector(inspectors, inspector, bus);
+        inspectors.transfersCount++;
+        return inspector;
+    }
+    return -1;
+}
+
+int finishInspection(Inspectors& inspectors, Passengers& passengers, Fleet& fleet, int bus) {
+    int inspector = inspectors.busInspector[bus];
+    if (inspector < 0)
+        return -1;
+
+    int fined = inspectBus(passengers, fleet, bus);
+    inspectors.inspectionsCount++;
+    inspectors.finedCount += fined;
+
+    // Kontrolor izlazi; automatski kontrolor ceka sledeci autobus na ovoj stanici
+    inspectors.busInspector[bus] = -1;
+    inspectors.bus[inspector] = -1;
+    inspectors.lastBus[inspector] = bus;
+    if (inspector != PLAYER_INSPECTOR) {
+        int station = fleet.stationIndex[bus];
+        inspectors.stop[inspector] = station;
+        inspectors.nextWaiting[inspector] = inspectors.waitingHead[station];
+        inspectors.waitingHead[station] = inspector;
+    }
+    return fined;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include "Fleet.h"
+#include "Passengers.h"
+
+// Kontrolori karata. Kontrolor ulazi u autobus na stanici, vozi se do sledece stanice, tamo
+// izbacuje putnike bez karte i izlazi, pa ceka na toj stanici sledeci autobus po pravilu
+// presedanja (policy). Stanje je u paralelnim nizovima zauzetim unapred, a kontrolori koji cekaju
+// na istoj stanici su povezani kroz niz nextWaiting, pa ni hiljade kontrolora ne zauzimaju
+// memoriju u toku rada. U jednom autobusu je najvise jedan kontrolor.
+
+// Pravila presedanja (--inspector-policy)
+enum TransferPolicy {
+    TRANSFER_NEXT_BUS,    // "next": ulazi u prvi autobus koji krene sa stanice
+    TRANSFER_LOADED_BUS,  // "loaded": ceka autobus sa bar INSPECTOR_MIN_LOAD putnika
+    TRANSFER_RANDOM_BUS   // "random": za svaki autobus baca novcic (tok STREAM_INSPECTION kontrolora)
+};
+
+// Koliko putnika mora da bude u autobusu da bi kontrolor sa pravilom "loaded" usao (pola autobusa)
+const int INSPECTOR_MIN_LOAD = 25;
+// Posle ovoliko propustenih autobusa kontrolor ulazi u sledeci, bez obzira na pravilo (i ako je to
+// autobus iz koga je izasao, npr. kad liniju vozi samo jedan autobus)
+const int INSPECTOR_MAX_SKIPPED = 4;
+
+// Kontrolor kojim upravlja korisnik (startControl): nije u sluzbi dok ga korisnik ne posalje u
+// autobus PLAYER_BUS i posle kontrole odlazi, umesto da ceka sledeci autobus.
+// Automatski kontrolori su 1 .. count.
+const int PLAYER_INSPECTOR = 0;
+
+struct Inspectors {
+    int count = 0;                    // Broj automatskih kontrolora
+    int policy = TRANSFER_NEXT_BUS;
+    unsigned long long seed = 0;
+
+    // Kolone (indeks je oznaka kontrolora, 0 je PLAYER_INSPECTOR)
+    std::vector<int> bus;             // Autobus u kome je kontrolor (-1 ako ne vozi)
+    std::vector<int> stop;            // Stanica na kojoj ceka (-1 ako ne ceka)
+    std::vector<int> lastBus;         // Autobus iz koga je poslednji izasao (u njega ne ulazi ponovo)
+    std::vector<int> skipped;         // Koliko je autobusa propustio od kada ceka
+    std::vector<int> nextWaiting;     // Sledeci kontrolor koji ceka na istoj stanici
+    std::vector<unsigned int> draws;  // Koliko je puta bacao novcic (brojac toka STREAM_INSPECTION)
+
+    std::vector<int> busInspector;    // Kontrolor u autobusu (-1 ako ga nema)
+    std::vector<int> waitingHead;     // Prvi kontrolor koji ceka na stanici (-1 ako nijedan)
+
+    // Statistika
+    long long inspectionsCount = 0;
+    long long finedCount = 0;
+    long long transfersCount = 0;
+};
+
+// Zauzima sve nizove i rasporedjuje numInspectors kontrolora na nasumicne stanice
+void initInspectors(Inspectors& inspectors, int numInspectors, int policy, int numBuses, int numStops,
+    unsigned long long seed);
+
+// Pravilo presedanja iz imena ("next", "loaded", "random"), -1 ako ime nije poznato
+int parseTransferPolicy(const char* name);
+
+// Da li je u autobusu kontrolor
+inline bool isBusInspected(const Inspectors& inspectors, int bus) {
+    return inspectors.busInspector[bus] >= 0;
+}
+
+// Kontrolor koji ne vozi ulazi u autobus (vraca false ako je u autobusu vec neki kontrolor)
+bool boardInspector(Inspectors& inspectors, int inspector, int bus);
+
+// Autobus polazi sa stanice fleet.fromStation[bus] (posle ulaska putnika): ako u njemu nema
+// kontrolora, ulazi prvi kontrolor sa te stanice kome pravilo presedanja to dozvoljava.
+// Vraca oznaku kontrolora ili -1.
+int boardWaitingInspector(Inspectors& inspectors, const Fleet& fleet, int bus);
+
+// Autobus je stigao na stanicu: kontrolor iz njega (ako ga ima) izbacuje putnike bez karte i
+// izlazi. Vraca broj kaznjenih ili -1 ako u autobusu nije bilo kontrolora.
+int finishInspection(Inspectors& inspectors, Passengers& passengers, Fleet& fleet, int bus);
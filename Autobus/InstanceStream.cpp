@@ -0,0 +1,101 @@
+#include "InstanceStream.h"
+#include "GlState.h"
+#include "Metrics.h"
+#include <GL/glew.h>
+
+// Pomeraji regiona su poravnati, da bi atributi u regionu bili poravnati bez obzira na velicinu
+const size_t INSTANCE_REGION_ALIGNMENT = 256;
+
+// Koliko dugo se najvise ceka ograda u jednom pozivu glClientWaitSync (nanosekunde)
+const GLuint64 INSTANCE_FENCE_WAIT_NANOSECONDS = 1000000;
+
+static const int STREAM_WAITS_METRIC = registerMetric(METRIC_COUNTER, "autobus_instance_stream_waits_total", nullptr,
+    "Frejmovi u kojima je procesor cekao da GPU oslobodi region bafera instanci");
+
+bool createInstanceStream(InstanceStream& stream, size_t regionBytes, bool allowPersistent) {
+    destroyInstanceStream(stream);
+    stream.regionBytes = (regionBytes + INSTANCE_REGION_ALIGNMENT - 1) / INSTANCE_REGION_ALIGNMENT * INSTANCE_REGION_ALIGNMENT;
+    stream.persistent = allowPersistent && (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage);
+
+    glGenBuffers(1, &stream.buffer);
+    bindArrayBuffer(stream.buffer);
+    if (stream.persistent) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr size = (GLsizeiptr)(stream.regionBytes * INSTANCE_STREAM_REGIONS);
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        stream.mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        if (stream.mapped == nullptr) {
+            // Mapiranje nije uspelo: bafer sa glBufferStorage je nepromenljive velicine, pa se pravi novi
+            bindArrayBuffer(0);
+            deleteBuffer(stream.buffer);
+            glGenBuffers(1, &stream.buffer);
+            bindArrayBuffer(stream.buffer);
+            stream.persistent = false;
+        }
+    }
+    if (!stream.persistent) {
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)stream.regionBytes, nullptr, GL_STREAM_DRAW);
+        stream.staging.resize(stream.regionBytes);
+    }
+    bindArrayBuffer(0);
+    return stream.buffer != 0;
+}
+
+void destroyInstanceStream(InstanceStream& stream) {
+    if (stream.buffer == 0)
+        return;
+    for (void*& fence : stream.fences) {
+        if (fence != nullptr)
+            glDeleteSync((GLsync)fence);
+        fence = nullptr;
+    }
+    if (stream.mapped != nullptr) {
+        bindArrayBuffer(stream.buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        bindArrayBuffer(0);
+    }
+    deleteBuffer(stream.buffer);
+    stream = InstanceStream();
+}
+
+void* beginInstanceStream(InstanceStream& stream) {
+    stream.frames++;
+    if (!stream.persistent)
+        return stream.staging.data();
+
+    stream.region = (stream.region + 1) % INSTANCE_STREAM_REGIONS;
+    GLsync fence = (GLsync)stream.fences[stream.region];
+    if (fence != nullptr) {
+        // Obicno je GPU odavno zavrsio sa regionom, pa prva provera ne ceka
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            stream.waits++;
+            addCounter(STREAM_WAITS_METRIC, 1);
+            do {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, INSTANCE_FENCE_WAIT_NANOSECONDS);
+            } while (status == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        stream.fences[stream.region] = nullptr;
+    }
+    return stream.mapped + stream.region * stream.regionBytes;
+}
+
+size_t endInstanceStream(InstanceStream& stream, size_t bytes) {
+    if (stream.persistent)
+        return stream.region * stream.regionBytes;
+
+    // Orphaning: drajver daje novu memoriju, a stara ostaje GPU-u dok ne zavrsi prethodne frejmove
+    bindArrayBuffer(stream.buffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)stream.regionBytes, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)bytes, stream.staging.data());
+    return 0;
+}
+
+void fenceInstanceStream(InstanceStream& stream) {
+    if (!stream.persistent)
+        return;
+    if (stream.fences[stream.region] != nullptr)
+        glDeleteSync((GLsync)stream.fences[stream.region]);
+    stream.fences[stream.region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
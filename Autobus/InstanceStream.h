@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Bafer instanci koji se puni svakog frejma (pozicije flote). Bafer ima INSTANCE_STREAM_REGIONS
+// regiona: dok GPU crta iz jednog, procesor pise u sledeci, a ograda (glFenceSync) posle crtanja
+// kaze kada je region ponovo slobodan, pa se procesor i GPU ne cekaju.
+//
+// Ako GL ima ARB_buffer_storage (GL 4.4), bafer je trajno mapiran (GL_MAP_PERSISTENT_BIT |
+// GL_MAP_COHERENT_BIT): beginInstanceStream vraca pokazivac pravo u memoriju koju GPU cita, pa se
+// podaci upisuju bez kopiranja. Inace se pise u bafer u memoriji procesora, a endInstanceStream
+// napusta stari sadrzaj bafera (glBufferData sa NULL, "orphaning") i salje nove podatke
+// glBufferSubData pozivom; tada regione menja drajver.
+
+const int INSTANCE_STREAM_REGIONS = 3;
+
+struct InstanceStream {
+    unsigned int buffer = 0;
+    size_t regionBytes = 0;
+    int region = 0;                      // Region u koji se pise u ovom frejmu
+    bool persistent = false;             // Trajno mapiran bafer (inace orphaning)
+    unsigned char* mapped = nullptr;     // Ceo trajno mapiran bafer
+    std::vector<unsigned char> staging;  // Podaci frejma bez trajnog mapiranja
+    void* fences[INSTANCE_STREAM_REGIONS] = {};   // GLsync po regionu (0: region je slobodan)
+    long long frames = 0;
+    long long waits = 0;                 // Frejmovi u kojima je procesor cekao da GPU oslobodi region
+};
+
+// Pravi bafer sa regionima od po regionBytes bajtova; allowPersistent = false trazi orphaning i
+// kada je trajno mapiranje dostupno. Vraca false ako bafer ne moze da se napravi.
+bool createInstanceStream(InstanceStream& stream, size_t regionBytes, bool allowPersistent);
+void destroyInstanceStream(InstanceStream& stream);
+
+// Prelazi na sledeci region i vraca pokazivac u koji se upisuje najvise regionBytes bajtova
+// (ceka samo ako GPU jos crta iz tog regiona od pre INSTANCE_STREAM_REGIONS frejmova)
+void* beginInstanceStream(InstanceStream& stream);
+
+// Zavrsava upis bytes bajtova; vraca pomeraj regiona u baferu (za glVertexAttribPointer)
+size_t endInstanceStream(InstanceStream& stream, size_t bytes);
+
+// Posle poslednjeg crtanja iz regiona: ograda posle koje region moze ponovo da se pise
+void fenceInstanceStream(InstanceStream& stream);
@@ -0,0 +1,174 @@
+#include "Interpolation.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define INTERPOLATION_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang traze da funkcija sa AVX2 instrukcijama bude oznacena; MSVC ih dozvoljava uvek
+#if defined(__GNUC__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+void interpolateSegmentsScalar(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n) {
+    for (int i = 0; i < n; ++i) {
+        float t = time[i] * invDuration;
+        t = t > 1.0f ? 1.0f : t;
+
+        int startIdx = 2 * fromIdx[i];
+        int endIdx = toIdx ? 2 * toIdx[i] : startIdx + 2;
+        outX[i] = points[startIdx] * (1.0f - t) + points[endIdx] * t;
+        outY[i] = points[startIdx + 1] * (1.0f - t) + points[endIdx + 1] * t;
+    }
+}
+
+#ifdef INTERPOLATION_X86
+
+// SSE nema gather instrukciju, pa se koordinate ucitavaju pojedinacno, a racuna se po 4 autobusa
+TARGET_SSE2
+void interpolateSegmentsSse(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 inv = _mm_set1_ps(invDuration);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 t = _mm_min_ps(_mm_mul_ps(_mm_loadu_ps(time + i), inv), one);
+        __m128 s = _mm_sub_ps(one, t);
+
+        // Indeksi x koordinata u nizu (x, y) parova
+        const int* from = fromIdx + i;
+        int a[4] = { 2 * from[0], 2 * from[1], 2 * from[2], 2 * from[3] };
+        int b[4] = { a[0] + 2, a[1] + 2, a[2] + 2, a[3] + 2 };
+        if (toIdx) {
+            const int* to = toIdx + i;
+            b[0] = 2 * to[0]; b[1] = 2 * to[1]; b[2] = 2 * to[2]; b[3] = 2 * to[3];
+        }
+        __m128 xA = _mm_setr_ps(points[a[0]], points[a[1]], points[a[2]], points[a[3]]);
+        __m128 yA = _mm_setr_ps(points[a[0] + 1], points[a[1] + 1], points[a[2] + 1], points[a[3] + 1]);
+        __m128 xB = _mm_setr_ps(points[b[0]], points[b[1]], points[b[2]], points[b[3]]);
+        __m128 yB = _mm_setr_ps(points[b[0] + 1], points[b[1] + 1], points[b[2] + 1], points[b[3] + 1]);
+
+        _mm_storeu_ps(outX + i, _mm_add_ps(_mm_mul_ps(xA, s), _mm_mul_ps(xB, t)));
+        _mm_storeu_ps(outY + i, _mm_add_ps(_mm_mul_ps(yA, s), _mm_mul_ps(yB, t)));
+    }
+    interpolateSegmentsScalar(points, fromIdx + i, toIdx ? toIdx + i : nullptr, time + i, invDuration, outX + i, outY + i, n - i);
+}
+
+// 8 autobusa po instrukciji; pocetne i krajnje koordinate se sakupljaju gather instrukcijom
+TARGET_AVX2
+void interpolateSegmentsAvx2(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 inv = _mm256_set1_ps(invDuration);
+    const __m256i nextPoint = _mm256_set1_epi32(2);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 t = _mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(time + i), inv), one);
+        __m256 s = _mm256_sub_ps(one, t);
+
+        // Indeks tacke * 2 = indeks x koordinate u nizu (x, y) parova
+        __m256i a = _mm256_slli_epi32(_mm256_loadu_si256((const __m256i*)(fromIdx + i)), 1);
+        __m256i b = toIdx ? _mm256_slli_epi32(_mm256_loadu_si256((const __m256i*)(toIdx + i)), 1)
+            : _mm256_add_epi32(a, nextPoint);
+
+        __m256 xA = _mm256_i32gather_ps(points, a, 4);
+        __m256 yA = _mm256_i32gather_ps(points + 1, a, 4);
+        __m256 xB = _mm256_i32gather_ps(points, b, 4);
+        __m256 yB = _mm256_i32gather_ps(points + 1, b, 4);
+
+        _mm256_storeu_ps(outX + i, _mm256_add_ps(_mm256_mul_ps(xA, s), _mm256_mul_ps(xB, t)));
+        _mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_mul_ps(yA, s), _mm256_mul_ps(yB, t)));
+    }
+    interpolateSegmentsScalar(points, fromIdx + i, toIdx ? toIdx + i : nullptr, time + i, invDuration, outX + i, outY + i, n - i);
+}
+
+bool cpuSupportsSse() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0; // SSE2
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool cpuSupportsAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // Operativni sistem mora da cuva YMM registre (OSXSAVE + XCR0)
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#else
+
+// Na procesorima koji nisu x86 postoji samo skalarna verzija
+void interpolateSegmentsSse(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n) {
+    interpolateSegmentsScalar(points, fromIdx, toIdx, time, invDuration, outX, outY, n);
+}
+
+void interpolateSegmentsAvx2(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n) {
+    interpolateSegmentsScalar(points, fromIdx, toIdx, time, invDuration, outX, outY, n);
+}
+
+bool cpuSupportsSse() {
+    return false;
+}
+
+bool cpuSupportsAvx2() {
+    return false;
+}
+
+#endif
+
+static InterpolationKernel selectInterpolationKernel() {
+    if (cpuSupportsAvx2())
+        return interpolateSegmentsAvx2;
+    if (cpuSupportsSse())
+        return interpolateSegmentsSse;
+    return interpolateSegmentsScalar;
+}
+
+InterpolationKernel getInterpolationKernel() {
+    static const InterpolationKernel kernel = selectInterpolationKernel();
+    return kernel;
+}
+
+const char* getInterpolationKernelName() {
+    InterpolationKernel kernel = getInterpolationKernel();
+    if (kernel == interpolateSegmentsAvx2)
+        return "AVX2";
+    if (kernel == interpolateSegmentsSse)
+        return "SSE";
+    return "skalarna";
+}
+
+void interpolateSegments(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n) {
+    getInterpolationKernel()(points, fromIdx, toIdx, time, invDuration, outX, outY, n);
+}
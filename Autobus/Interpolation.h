@@ -0,0 +1,31 @@
+#pragma once
+
+// Interpolacija pozicija izmedju dve tacke za mnogo autobusa odjednom:
+//   t = min(time[i] * invDuration, 1)
+//   out[i] = points[fromIdx[i]] * (1 - t) + points[toIdx[i]] * t
+// points su (x, y) parovi, kao stationPositions. Ako je toIdx NULL, krajnja tacka je sledeca
+// tacka u nizu (fromIdx[i] + 1), kao kod pracenja izlomljene linije. Pored skalarne verzije postoje SSE i AVX2
+// verzije (AVX2 sakuplja koordinate za 8 autobusa jednom instrukcijom); koja ce se koristiti
+// bira se pri pokretanju prema mogucnostima procesora.
+
+typedef void (*InterpolationKernel)(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n);
+
+void interpolateSegmentsScalar(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n);
+void interpolateSegmentsSse(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n);
+void interpolateSegmentsAvx2(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n);
+
+// Da li procesor podrzava odgovarajuci skup instrukcija
+bool cpuSupportsSse();
+bool cpuSupportsAvx2();
+
+// Najbrza verzija koju procesor podrzava (bira se jednom) i njeno ime
+InterpolationKernel getInterpolationKernel();
+const char* getInterpolationKernelName();
+
+// Poziva najbrzu dostupnu verziju
+void interpolateSegments(const float* points, const int* fromIdx, const int* toIdx,
+    const float* time, float invDuration, float* outX, float* outY, int n);
@@ -0,0 +1,224 @@
+#include "Logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+static const char LOG_MAGIC[8] = { 'A', 'U', 'T', 'O', 'L', 'O', 'G', '1' };
+
+// Koliko pozadinska nit spava kad nema novih zapisa
+const int LOG_WRITER_SLEEP_MICROSECONDS = 200;
+
+// Kruzni bafer jedne niti: nit upisuje na head, pozadinska nit cita od tail. Brojaci samo rastu
+// (indeks u baferu je brojac & (LOG_RING_RECORDS - 1)), a head i tail su u razlicitim linijama
+// kesa da se pisac i citalac ne bi ometali.
+struct LogRing {
+    std::atomic<unsigned int> head;
+    char headPadding[64 - sizeof(std::atomic<unsigned int>)];
+    std::atomic<unsigned int> tail;
+    char tailPadding[64 - sizeof(std::atomic<unsigned int>)];
+    unsigned int cachedTail;          // Poslednji procitan tail (samo pisac), da ga ne cita svaki put
+    std::atomic<long long> dropped;
+    LogRecord records[LOG_RING_RECORDS];
+};
+
+static std::atomic<bool> logEnabled(false);
+static std::atomic<bool> writerRunning(false);
+static std::atomic<int> logGeneration(0);
+static std::atomic<LogRing*> logRings[LOG_MAX_THREADS];
+static std::atomic<int> logRingCount(0);
+static std::atomic<long long> loggedCount(0);
+static long long droppedAtStop = 0;
+static std::thread writerThread;
+static FILE* logFile = nullptr;
+
+// Bafer tekuce niti; generation razlikuje bafere prethodnog pokretanja dnevnika
+static thread_local LogRing* threadRing = nullptr;
+static thread_local int threadGeneration = -1;
+
+// Prebacuje sve zapise iz bafera u fajl, vraca broj prebacenih
+static long long drainRings() {
+    long long drained = 0;
+    int count = logRingCount.load(std::memory_order_acquire);
+    count = count < LOG_MAX_THREADS ? count : LOG_MAX_THREADS;
+    for (int i = 0; i < count; ++i) {
+        LogRing* ring = logRings[i].load(std::memory_order_acquire);
+        if (ring == nullptr)
+            continue;
+        unsigned int tail = ring->tail.load(std::memory_order_relaxed);
+        unsigned int head = ring->head.load(std::memory_order_acquire);
+        unsigned int available = head - tail;
+        if (available == 0)
+            continue;
+
+        // Najvise dva uzastopna dela bafera
+        unsigned int first = tail & (LOG_RING_RECORDS - 1);
+        unsigned int firstCount = LOG_RING_RECORDS - first < available ? LOG_RING_RECORDS - first : available;
+        fwrite(ring->records + first, sizeof(LogRecord), firstCount, logFile);
+        if (available > firstCount)
+            fwrite(ring->records, sizeof(LogRecord), available - firstCount, logFile);
+        ring->tail.store(head, std::memory_order_release);
+        drained += available;
+    }
+    loggedCount.fetch_add(drained, std::memory_order_relaxed);
+    return drained;
+}
+
+static void runLogWriter() {
+    while (writerRunning.load(std::memory_order_acquire)) {
+        if (drainRings() == 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(LOG_WRITER_SLEEP_MICROSECONDS));
+    }
+}
+
+bool startLog(const char* path) {
+    if (logEnabled.load())
+        stopLog();
+    logFile = fopen(path, "wb");
+    if (logFile == nullptr) {
+        std::cerr << "Greska pri otvaranju dnevnika \"" << path << "\"!" << std::endl;
+        return false;
+    }
+    unsigned int version[2] = { 1, (unsigned int)sizeof(LogRecord) };
+    fwrite(LOG_MAGIC, 1, sizeof(LOG_MAGIC), logFile);
+    fwrite(version, sizeof(version), 1, logFile);
+
+    loggedCount = 0;
+    droppedAtStop = 0;
+    logGeneration++;
+    writerRunning = true;
+    writerThread = std::thread(runLogWriter);
+    logEnabled = true;
+    return true;
+}
+
+static long long sumDropped() {
+    long long dropped = 0;
+    int count = logRingCount.load();
+    for (int i = 0; i < count && i < LOG_MAX_THREADS; ++i) {
+        LogRing* ring = logRings[i].load();
+        if (ring != nullptr)
+            dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void stopLog() {
+    if (!logEnabled.load())
+        return;
+    logEnabled = false;
+    writerRunning = false;
+    writerThread.join();
+    drainRings();
+    droppedAtStop = sumDropped();
+    fclose(logFile);
+    logFile = nullptr;
+
+    int count = logRingCount.load();
+    for (int i = 0; i < count && i < LOG_MAX_THREADS; ++i)
+        delete logRings[i].exchange(nullptr);
+    logRingCount = 0;
+    logGeneration++;
+}
+
+bool isLogEnabled() {
+    return logEnabled.load(std::memory_order_relaxed);
+}
+
+// Prvi zapis niti u ovom pokretanju dnevnika: nit dobija svoj bafer
+static LogRing* registerLogThread() {
+    threadGeneration = logGeneration.load();
+    threadRing = nullptr;
+    int index = logRingCount.fetch_add(1);
+    if (index >= LOG_MAX_THREADS)
+        return nullptr;
+    LogRing* ring = new LogRing();
+    ring->head = 0;
+    ring->tail = 0;
+    ring->cachedTail = 0;
+    ring->dropped = 0;
+    logRings[index].store(ring, std::memory_order_release);
+    threadRing = ring;
+    return ring;
+}
+
+void logEvent(int type, double time, int bus, int a, int b) {
+    if (!logEnabled.load(std::memory_order_relaxed))
+        return;
+    LogRing* ring = threadRing;
+    if (threadGeneration != logGeneration.load(std::memory_order_relaxed))
+        ring = registerLogThread();
+    if (ring == nullptr)
+        return;
+
+    unsigned int head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->cachedTail >= (unsigned int)LOG_RING_RECORDS) {
+        ring->cachedTail = ring->tail.load(std::memory_order_acquire);
+        if (head - ring->cachedTail >= (unsigned int)LOG_RING_RECORDS) {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    LogRecord& record = ring->records[head & (LOG_RING_RECORDS - 1)];
+    record.time = time;
+    record.type = type;
+    record.bus = bus;
+    record.a = a;
+    record.b = b;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+long long getLoggedCount() {
+    return loggedCount.load();
+}
+
+long long getDroppedLogCount() {
+    return logEnabled.load() ? sumDropped() : droppedAtStop;
+}
+
+int formatLog(const char* path) {
+    FILE* file = fopen(path, "rb");
+    char magic[sizeof(LOG_MAGIC)];
+    unsigned int version[2];
+    if (file == nullptr || fread(magic, 1, sizeof(magic), file) != sizeof(magic) || memcmp(magic, LOG_MAGIC, sizeof(magic)) != 0
+        || fread(version, sizeof(version), 1, file) != 1 || version[1] != sizeof(LogRecord)) {
+        if (file != nullptr)
+            fclose(file);
+        std::cerr << "Fajl \"" << path << "\" nije dnevnik simulacije." << std::endl;
+        return -1;
+    }
+
+    // Dnevnik moze biti veliki, pa se cita i ispisuje u delovima (printf umesto std::endl, bez praznjenja po liniji)
+    LogRecord records[4096];
+    size_t count;
+    while ((count = fread(records, sizeof(LogRecord), 4096, file)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            const LogRecord& r = records[i];
+            printf("%12.3f s  autobus %d: ", r.time, r.bus);
+            switch (r.type) {
+            case LOG_BOARDING:
+                printf("uslo %d putnika na stanici %d\n", r.b, r.a);
+                break;
+            case LOG_ALIGHTING:
+                printf("izaslo %d putnika na stanici %d\n", r.b, r.a);
+                break;
+            case LOG_INSPECTION:
+                printf("kontrola na stanici %d, kaznjeno %d putnika\n", r.a, r.b);
+                break;
+            case LOG_CONTROL_START:
+                printf("kontrolor je usao u autobus\n");
+                break;
+            case LOG_PLAYER_PASSENGERS:
+                printf("broj putnika: %d\n", r.a);
+                break;
+            default:
+                printf("nepoznat dogadjaj %d\n", r.type);
+                break;
+            }
+        }
+    }
+    fclose(file);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+// Dnevnik dogadjaja simulacije (ulasci, izlasci, kontrole, ulazi korisnika) bez ispisa na konzolu
+// u toku rada. Svaki dogadjaj je binarni zapis fiksne velicine koji se upisuje u kruzni bafer niti
+// koja ga je napravila (jedan pisac, jedan citalac, bez zakljucavanja); pozadinska nit prazni
+// bafere u fajl. Tekst se pravi tek posle, iz fajla (--format-log). Kad je bafer pun, zapis se
+// odbacuje i broji, da simulacija nikad ne bi cekala na disk.
+
+enum LogEventType {
+    LOG_BOARDING = 1,        // a: stanica, b: broj putnika koji su usli
+    LOG_ALIGHTING,           // a: stanica, b: broj putnika koji su izasli
+    LOG_INSPECTION,          // a: stanica, b: broj kaznjenih
+    LOG_CONTROL_START,       // Kontrolor korisnika je usao u autobus
+    LOG_PLAYER_PASSENGERS,   // a: broj putnika u autobusu posle klika ili kontrole korisnika
+    LOG_TYPE_COUNT
+};
+
+// Zapis u fajlu i u baferima (24 bajta)
+struct LogRecord {
+    double time;   // Simulirano vreme
+    int type;      // LogEventType
+    int bus;
+    int a;
+    int b;
+};
+
+// Zapisa u baferu svake niti i najvise niti koje pisu u dnevnik
+const int LOG_RING_RECORDS = 1 << 16;
+const int LOG_MAX_THREADS = 64;
+
+// Pokrece pozadinsku nit koja upisuje dnevnik u fajl; vraca false ako fajl ne moze da se otvori
+bool startLog(const char* path);
+
+// Prazni sve bafere, zaustavlja pozadinsku nit i zatvara fajl (niti koje pisu moraju biti gotove)
+void stopLog();
+
+// Da li je dnevnik pokrenut
+bool isLogEnabled();
+
+// Upisuje dogadjaj u bafer tekuce niti (ako je dnevnik pokrenut)
+void logEvent(int type, double time, int bus, int a, int b);
+
+// Broj upisanih i odbacenih zapisa od pokretanja
+long long getLoggedCount();
+long long getDroppedLogCount();
+
+// Ispisuje dnevnik iz fajla kao tekst (jedan dogadjaj po liniji), vraca -1 ako fajl nije ispravan
+int formatLog(const char* path);
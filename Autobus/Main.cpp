@@ -3,39 +3,105 @@
 #include <iostream>
 #include <cmath>
 #include <vector>
-#include <cstdlib>
-#include <ctime>
 #include "Util.h"
+#include "Simulation.h"
+#include "Headless.h"
+#include "Benchmark.h"
+#include "Options.h"
+#include "EventScheduler.h"
+#include "Snapshot.h"
+#include "InputLog.h"
+#include "Logger.h"
+#include "Telemetry.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include "GpuTimer.h"
+#include "ShaderProgram.h"
+#include "InstanceStream.h"
+#include "GlState.h"
+#include "Atlas.h"
+#include "SpriteBatch.h"
+#include "BenchmarkReport.h"
+#include <chrono>
 
 #define M_PI 3.14159265358979323846
 
-unsigned busTexture;
-unsigned stationTexture;
-unsigned int colorShader;
-unsigned int rectShader;
-unsigned closedIconTexture;
-unsigned openIconTexture;
-unsigned controlIconTexture;
-unsigned nameTexture;
-bool showControls = false;
+TextureAtlas atlas;       // Sve slike scene u jednoj teksturi (Atlas.h)
+unsigned stationTexture;  // Stanica u posebnoj teksturi, samo za poredjenje u --bench suite
+ShaderProgram colorShader;
+ShaderProgram rectShader;
+ShaderProgram stationShader;
+ShaderProgram busShader;
+ShaderProgram spriteShader;
+
+// Regioni slika u atlasu (nalaze se jednom u loadAtlas)
+int busRegion, closedIconRegion, openIconRegion, controlIconRegion, nameRegion;
+
+// Uniforme sejdera (brojevi u tabelama programa, nalaze se jednom u loadShaders)
+int rectUX, rectUY, rectUS, rectUTex0;
+int colorUColor, colorUPosOffset;
+int stationURegions, stationUTex0;
+int busUS, busURegion, busUTex0;
+int spriteUTex0;
+
+// Slike iz res/ koje idu u atlas (pointer.png je kursor, njega crta GLFW, a ne GL)
+const char* const ATLAS_IMAGES[] = { "res/avtobus.png", "res/busstation.jpeg", "res/zatvorena.png",
+    "res/otvorena.png", "res/kontrola.png", "res/ime.png" };
+const int ATLAS_PADDING = 2;
+const int ATLAS_MAX_IMAGE_SIZE = 1024;
+
+// Slike stanica (sloj u podacima stanice je broj slike u ovom nizu)
+const char* const STATION_TEXTURES[] = { "res/busstation.jpeg" };
+const int STATION_LAYER_DEFAULT = 0;
+const int STATION_LAYERS_MAX = 4;   // Velicina niza uRegions u station.vert
+static_assert(sizeof(STATION_TEXTURES) / sizeof(STATION_TEXTURES[0]) <= STATION_LAYERS_MAX, "Previse slika stanica");
+
+// Slojevi spritova: manji sloj se crta pre (ispod)
+enum SpriteLayer {
+    SPRITE_LAYER_ICONS,
+    SPRITE_LAYER_NAME
+};
+const int HUD_SPRITES = 8;   // Kapacitet jednog poziva crtanja spritova
 
 int screenWidth = 1700;
 int screenHeight = 1100;
 const float BUS_SCALE = 0.25f; 
 const float STATION_SCALE = 0.15f;
 
-// --- Konstante kretanja ---
-const float TRAVEL_TIME_SECONDS = 5.0f;
-const float STATION_WAIT_SECONDS = 10.0f;
-
-int currentStationIndex = 0;
-float currentSegmentTime = 0.0f;
-bool isWaiting = true;
-float waitTimer = 0.0f;
-int passengersNumber = 0;
-int punishmentNumber = 0;
+// Stanje autobusa, stanica i putnika (prozor samo prikazuje simulaciju)
+Simulation sim;
 
 double lastTime; // Koristi se za deltaTime
+double stepAccumulator = 0.0; // Neiskorisceno vreme izmedju fiksnih koraka simulacije
+
+// --events: simulacija vodjena dogadjajima umesto fiksnih koraka
+bool eventDriven = false;
+EventScheduler scheduler;
+
+// Fajl u koji F5 upisuje snimak stanja (--snapshot)
+const char* snapshotPath = "autobus.snap";
+
+// Fajl u koji F6 i izlaz iz programa upisuju profil poslednjih profileFrames frejmova
+// (--profile, --profile-frames; samo u izdanju sa AUTOBUS_PROFILE)
+const char* profilePath = "profile.json";
+int profileFrames = PROFILE_DEFAULT_FRAMES;
+
+// --record <fajl>: ulazi korisnika se snimaju da bi se sesija ponovila sa --replay
+InputRecorder inputRecorder;
+
+// Metrike prozora (vidi Metrics.h): trajanje frejma, simulacije u frejmu i crtanja svakog dela scene
+const int FRAME_SECONDS_METRIC = registerMetric(METRIC_HISTOGRAM, "autobus_frame_seconds", nullptr, "Trajanje frejma", 1e-9);
+const int FRAMES_METRIC = registerMetric(METRIC_COUNTER, "autobus_frames_total", nullptr, "Broj frejmova");
+const int FRAME_SIMULATION_METRIC = registerMetric(METRIC_HISTOGRAM, "autobus_frame_simulation_seconds", nullptr,
+    "Trajanje simulacije u jednom frejmu", 1e-9);
+const char* const DRAW_HELP = "Trajanje crtanja dela scene (slanje komandi, bez cekanja GPU-a)";
+const int DRAW_PATH_METRIC = registerMetric(METRIC_HISTOGRAM, "autobus_draw_seconds", "pass=\"path\"", DRAW_HELP, 1e-9);
+const int DRAW_STATIONS_METRIC = registerMetric(METRIC_HISTOGRAM, "autobus_draw_seconds", "pass=\"stations\"", DRAW_HELP, 1e-9);
+const int DRAW_BUS_METRIC = registerMetric(METRIC_HISTOGRAM, "autobus_draw_seconds", "pass=\"bus\"", DRAW_HELP, 1e-9);
+const int DRAW_HUD_METRIC = registerMetric(METRIC_HISTOGRAM, "autobus_draw_seconds", "pass=\"hud\"", DRAW_HELP, 1e-9);
+
+// Koliko cesto se metrike upisuju u fajl (--metrics)
+const double METRICS_DUMP_SECONDS = 1.0;
 
 int endProgram(std::string message) {
     std::cerr << message << std::endl;
@@ -46,12 +112,12 @@ int endProgram(std::string message) {
 void preprocessTexture(unsigned& texture, const char* filepath) {
     texture = loadImageToTexture(filepath);
     if (texture != 0) {
-        glBindTexture(GL_TEXTURE_2D, texture);
+        bindTexture2D(texture);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        bindTexture2D(0);
     }
 }
 
@@ -61,8 +127,8 @@ void formVAOTextured(float* vertices, size_t size, unsigned int& VAO) {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    bindVertexArray(VAO);
+    bindArrayBuffer(VBO);
     glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
 
     // Atribut 0 (pozicija): x, y
@@ -73,8 +139,8 @@ void formVAOTextured(float* vertices, size_t size, unsigned int& VAO) {
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    bindArrayBuffer(0);
+    bindVertexArray(0);
 }
 
 // Funkcija za formiranje VAO-a samo sa pozicijom (za crvenu putanju)
@@ -83,172 +149,612 @@ void formVAOPosition(std::vector<float> vertices, size_t size, unsigned int& VAO
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    bindVertexArray(VAO);
+    bindArrayBuffer(VBO);
     glBufferData(GL_ARRAY_BUFFER, size, vertices.data(), GL_STATIC_DRAW);
 
     // Atribut 0 (pozicija): x, y
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    bindArrayBuffer(0);
+    bindVertexArray(0);
 }
 
-float randomOffset(float range) {
-    // Generisanje broja izmedju 0 i 1, pa skaliranje i pomeranje
-    return (float(rand()) / RAND_MAX * 2.0f - 1.0f) * range;
+// Stanice se crtaju jednim instanciranim pozivom: VAO ima kvadrat (atributi 0 i 1) i bafer sa po
+// jednim zapisom po stanici (atribut 2: x, y, skaliranje, sloj teksture). Bafer se puni samo kada
+// se promene stanice (nova revizija mreze, vidi markNetworkChanged) ili skaliranje, a ne svakog frejma.
+struct StationInstances {
+    unsigned int VAO = 0;
+    unsigned int quadVBO = 0;
+    unsigned int instanceVBO = 0;
+    int count = 0;
+    unsigned int revision = 0;   // Revizija mreze iz koje je bafer napunjen (0: bafer je prazan)
+    float scale = 0.0f;
+};
+
+void formVAOStations(StationInstances& stations, float* vertices, size_t size) {
+    glGenVertexArrays(1, &stations.VAO);
+    glGenBuffers(1, &stations.quadVBO);
+    glGenBuffers(1, &stations.instanceVBO);
+
+    bindVertexArray(stations.VAO);
+    bindArrayBuffer(stations.quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // Atribut 2 se menja po instanci (stanici), a ne po temenu
+    bindArrayBuffer(stations.instanceVBO);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+
+    bindArrayBuffer(0);
+    bindVertexArray(0);
+    stations.count = 0;
+    stations.revision = 0;
 }
 
-void drawPath(unsigned int pathShader, unsigned int VAOpath, int numPoints) {
-    glUseProgram(pathShader);
-    glUniform4f(glGetUniformLocation(pathShader, "uColor"), 1.0f, 0.0f, 0.0f, 1.0f);
-    glUniform2f(glGetUniformLocation(pathShader, "uPosOffset"), 0.0f, 0.0f);
+void updateStationInstances(StationInstances& stations, const Network& network, float scale) {
+    if (stations.revision != 0 && stations.revision == network.revision && stations.scale == scale)
+        return;
+    int numStations = network.numStops;
+    const float* stationPositions = network.stopPositions.data();
+    std::vector<float> instances(4 * (size_t)numStations);
+    for (int i = 0; i < numStations; ++i) {
+        instances[4 * i] = stationPositions[2 * i];
+        instances[4 * i + 1] = stationPositions[2 * i + 1];
+        instances[4 * i + 2] = scale;
+        instances[4 * i + 3] = (float)STATION_LAYER_DEFAULT;
+    }
+    bindArrayBuffer(stations.instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(float), instances.data(), GL_STATIC_DRAW);
+    bindArrayBuffer(0);
+    stations.count = numStations;
+    stations.revision = network.revision;
+    stations.scale = scale;
+}
+
+void destroyStationInstances(StationInstances& stations) {
+    deleteVertexArray(stations.VAO);
+    deleteBuffer(stations.quadVBO);
+    deleteBuffer(stations.instanceVBO);
+    stations = StationInstances();
+}
+
+// Pravi atlas od slika scene i nalazi regione slika koje se crtaju
+bool loadAtlas() {
+    if (!buildTextureAtlas(atlas, ATLAS_IMAGES, sizeof(ATLAS_IMAGES) / sizeof(ATLAS_IMAGES[0]), ATLAS_PADDING, ATLAS_MAX_IMAGE_SIZE))
+        return false;
+    busRegion = findAtlasRegion(atlas, "res/avtobus.png");
+    closedIconRegion = findAtlasRegion(atlas, "res/zatvorena.png");
+    openIconRegion = findAtlasRegion(atlas, "res/otvorena.png");
+    controlIconRegion = findAtlasRegion(atlas, "res/kontrola.png");
+    nameRegion = findAtlasRegion(atlas, "res/ime.png");
+    for (const char* path : STATION_TEXTURES) {
+        if (findAtlasRegion(atlas, path) < 0)
+            return false;
+    }
+    return busRegion >= 0 && closedIconRegion >= 0 && openIconRegion >= 0 && controlIconRegion >= 0 && nameRegion >= 0;
+}
+
+// Pravi sejder programe i nalazi njihove uniforme (posle loadAtlas, jer zadaje regione slika)
+bool loadShaders() {
+    if (!createShaderProgram(rectShader, "rect.vert", "rect.frag") || !createShaderProgram(colorShader, "color.vert", "color.frag")
+        || !createShaderProgram(stationShader, "station.vert", "rect.frag") || !createShaderProgram(busShader, "bus.vert", "rect.frag")
+        || !createShaderProgram(spriteShader, "sprite.vert", "rect.frag"))
+        return false;
+    rectUX = findUniform(rectShader, "uX");
+    rectUY = findUniform(rectShader, "uY");
+    rectUS = findUniform(rectShader, "uS");
+    rectUTex0 = findUniform(rectShader, "uTex0");
+    colorUColor = findUniform(colorShader, "uColor");
+    colorUPosOffset = findUniform(colorShader, "uPosOffset");
+
+    stationURegions = findUniform(stationShader, "uRegions");
+    stationUTex0 = findUniform(stationShader, "uTex0");
+    busUS = findUniform(busShader, "uS");
+    busURegion = findUniform(busShader, "uRegion");
+    busUTex0 = findUniform(busShader, "uTex0");
+    spriteUTex0 = findUniform(spriteShader, "uTex0");
+
+    useShaderProgram(rectShader);
+    setUniform1i(rectShader, rectUTex0, 0);
+    useShaderProgram(stationShader);
+    setUniform1i(stationShader, stationUTex0, 0);
+    float stationRegions[4 * STATION_LAYERS_MAX] = {};
+    for (int layer = 0; layer < (int)(sizeof(STATION_TEXTURES) / sizeof(STATION_TEXTURES[0])); ++layer) {
+        const AtlasRegion& region = atlas.regions[findAtlasRegion(atlas, STATION_TEXTURES[layer])];
+        stationRegions[4 * layer] = region.u0;
+        stationRegions[4 * layer + 1] = region.v0;
+        stationRegions[4 * layer + 2] = region.u1;
+        stationRegions[4 * layer + 3] = region.v1;
+    }
+    setUniform4fv(stationShader, stationURegions, stationRegions, STATION_LAYERS_MAX);
+    useShaderProgram(busShader);
+    setUniform1i(busShader, busUTex0, 0);
+    setUniform1f(busShader, busUS, BUS_SCALE);
+    const AtlasRegion& bus = atlas.regions[busRegion];
+    setUniform4f(busShader, busURegion, bus.u0, bus.v0, bus.u1, bus.v1);
+    useShaderProgram(spriteShader);
+    setUniform1i(spriteShader, spriteUTex0, 0);
+    return true;
+}
+
+// Svaki segment mreze je posebna izlomljena linija (first/count: prva tacka i broj tacaka segmenta)
+void drawPath(ShaderProgram& pathShader, unsigned int VAOpath, const int* first, const int* count, int numSegments) {
+    PROFILE_FUNCTION();
+    unsigned long long drawStart = getMetricsClock();
+    useShaderProgram(pathShader);
+    setUniform4f(pathShader, colorUColor, 1.0f, 0.0f, 0.0f, 1.0f);
+    setUniform2f(pathShader, colorUPosOffset, 0.0f, 0.0f);
     glLineWidth(10.0f);
-    glBindVertexArray(VAOpath);
-    glDrawArrays(GL_LINE_LOOP, 0, numPoints);
-    glBindVertexArray(0);
+    bindVertexArray(VAOpath);
+    multiDrawArrays(GL_LINE_STRIP, first, count, numSegments);
+    recordHistogram(DRAW_PATH_METRIC, getMetricsClock() - drawStart);
+}
+
+// Sve stanice jednim pozivom (glDrawArraysInstanced), iz bafera koji puni updateStationInstances
+void drawStations(ShaderProgram& stationShader, const StationInstances& stations) {
+    PROFILE_FUNCTION();
+    unsigned long long drawStart = getMetricsClock();
+    useShaderProgram(stationShader);
+
+    activeTextureUnit(0);
+    bindTexture2D(atlas.texture);
+
+    bindVertexArray(stations.VAO);
+    drawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, stations.count);
+    recordHistogram(DRAW_STATIONS_METRIC, getMetricsClock() - drawStart);
 }
 
-// Funkcija za crtanje 10 stanica
-void drawStations(unsigned int rectShader, unsigned int VAOstation, float* stationPositions, int numStations) {
-    glUseProgram(rectShader);
+// Stanica po stanica, jedan poziv crtanja i tri uniforme po stanici (samo za poredjenje u --bench suite)
+void drawStationsOneByOne(ShaderProgram& rectShader, unsigned int VAOstation, const float* stationPositions, int numStations, float scale) {
+    useShaderProgram(rectShader);
 
     // Aktiviranje teksture stanice
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, stationTexture);
+    activeTextureUnit(0);
+    bindTexture2D(stationTexture);
 
-    glBindVertexArray(VAOstation);
+    bindVertexArray(VAOstation);
     for (int i = 0; i < numStations; ++i) {
         float x = stationPositions[2 * i];
         float y = stationPositions[2 * i + 1];
 
         // Skaliranje i pozicija
-        glUniform1f(glGetUniformLocation(rectShader, "uX"), x);
-        glUniform1f(glGetUniformLocation(rectShader, "uY"), y);
-        glUniform1f(glGetUniformLocation(rectShader, "uS"), STATION_SCALE);
+        setUniform1f(rectShader, rectUX, x);
+        setUniform1f(rectShader, rectUY, y);
+        setUniform1f(rectShader, rectUS, scale);
 
-        glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+        drawArrays(GL_TRIANGLE_FAN, 0, 4);
     }
-    glBindVertexArray(0);
 }
 
-// Funkcija za crtanje autobusa
-void drawBus(unsigned int rectShader, unsigned int VAObus, float currentX, float currentY) {
-    glUseProgram(rectShader);
-
-    // Skaliranje i pozicija
-    glUniform1f(glGetUniformLocation(rectShader, "uX"), currentX);
-    glUniform1f(glGetUniformLocation(rectShader, "uY"), currentY);
-    glUniform1f(glGetUniformLocation(rectShader, "uS"), BUS_SCALE);
+// Flota se crta jednim instanciranim pozivom iz toka instanci (InstanceStream.h). Region frejma
+// sadrzi sve x pa sve y koordinate, onako kako ih updateFleetPositions upisuje, pa atribut 2 (x)
+// pocinje na pocetku regiona, a atribut 3 (y) posle count x koordinata.
+struct FleetInstances {
+    unsigned int VAO = 0;
+    unsigned int quadVBO = 0;
+    InstanceStream stream;
+    int count = 0;
+    size_t offset = 0;   // Pomeraj regiona tekuceg frejma u baferu
+};
+
+bool formVAOFleet(FleetInstances& fleet, float* vertices, size_t size, int numBuses, bool allowPersistent) {
+    if (!createInstanceStream(fleet.stream, 2 * sizeof(float) * (numBuses > 0 ? numBuses : 1), allowPersistent))
+        return false;
+    fleet.count = numBuses;
+    fleet.offset = 0;
+    glGenVertexArrays(1, &fleet.VAO);
+    glGenBuffers(1, &fleet.quadVBO);
+
+    bindVertexArray(fleet.VAO);
+    bindArrayBuffer(fleet.quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
 
-    // Aktiviranje teksture autobusa
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, busTexture);
+    // Atributi 2 i 3 se menjaju po instanci (autobusu); pomeraj im postavlja drawFleet
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
 
-    glBindVertexArray(VAObus);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+    bindArrayBuffer(0);
+    bindVertexArray(0);
+    return true;
 }
 
-// Funkcija za crtanje ikone statusa (otvorena/zatvorena vrata)
-void drawStatusIcon(unsigned int rectShader, unsigned int VAO,
-    unsigned int closedTex, unsigned int openTex,
-    bool isWaiting) {
-
-    glUseProgram(rectShader);
+// Pozicije flote se racunaju pravo u region toka instanci (bez kopije preko posX/posY)
+void updateFleetInstances(FleetInstances& instances, Fleet& fleet, const RoutePath& route) {
+    float* out = (float*)beginInstanceStream(instances.stream);
+    updateFleetPositions(fleet, route, out, out + instances.count);
+    instances.offset = endInstanceStream(instances.stream, 2 * sizeof(float) * instances.count);
+}
 
-    // Biranje teksture
-    unsigned int currentTex = isWaiting ? openTex : closedTex;
+void destroyFleetInstances(FleetInstances& fleet) {
+    destroyInstanceStream(fleet.stream);
+    deleteVertexArray(fleet.VAO);
+    deleteBuffer(fleet.quadVBO);
+    fleet = FleetInstances();
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, currentTex);
+// Svi autobusi jednim pozivom (glDrawArraysInstanced), iz regiona koji je napunio updateFleetInstances
+void drawFleet(ShaderProgram& busShader, FleetInstances& fleet) {
+    PROFILE_FUNCTION();
+    unsigned long long drawStart = getMetricsClock();
+    useShaderProgram(busShader);
+
+    activeTextureUnit(0);
+    bindTexture2D(atlas.texture);
+
+    bindVertexArray(fleet.VAO);
+    bindArrayBuffer(fleet.stream.buffer);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)fleet.offset);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(fleet.offset + sizeof(float) * fleet.count));
+    drawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, fleet.count);
+    fenceInstanceStream(fleet.stream);
+    recordHistogram(DRAW_BUS_METRIC, getMetricsClock() - drawStart);
+}
 
+// Ikona statusa (otvorena/zatvorena vrata) u gornjem desnom uglu
+void addStatusIcon(SpriteBatch& sprites, bool isWaiting) {
     const float ICON_SCALE = 0.2f; // Skaliranje ikone
     const float ICON_X = 1.0f - (ICON_SCALE / 2.0f) - 0.05f;
     const float ICON_Y = 1.0f - (ICON_SCALE / 2.0f) - 0.05f;
 
-    glUniform1f(glGetUniformLocation(rectShader, "uX"), ICON_X);
-    glUniform1f(glGetUniformLocation(rectShader, "uY"), ICON_Y);
-    glUniform1f(glGetUniformLocation(rectShader, "uS"), ICON_SCALE);
-
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+    // Biranje slike
+    const AtlasRegion& region = atlas.regions[isWaiting ? openIconRegion : closedIconRegion];
+    addSprite(sprites, region, ICON_X, ICON_Y, ICON_SCALE, ICON_SCALE, SPRITE_LAYER_ICONS);
 }
 
-// Funkcija za crtanje oveka kontrolera
-void drawControlIcon(unsigned int rectShader, unsigned int VAO, unsigned int controlTex) {
-    glUseProgram(rectShader);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, controlTex);
-
+// ovek kontrolor u gornjem levom uglu
+void addControlIcon(SpriteBatch& sprites) {
     const float CONTROL_SCALE = 0.30f;
     const float MARGIN = 0.05f;
 
     const float CONTROL_X = -1.0f + (CONTROL_SCALE / 2.0f) + MARGIN;
     const float CONTROL_Y = 1.0f - (CONTROL_SCALE / 2.0f) - MARGIN;
 
-    glUniform1f(glGetUniformLocation(rectShader, "uX"), CONTROL_X);
-    glUniform1f(glGetUniformLocation(rectShader, "uY"), CONTROL_Y);
-    glUniform1f(glGetUniformLocation(rectShader, "uS"), CONTROL_SCALE);
-
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+    addSprite(sprites, atlas.regions[controlIconRegion], CONTROL_X, CONTROL_Y, CONTROL_SCALE, CONTROL_SCALE, SPRITE_LAYER_ICONS);
 }
 
-
-void drawMyName(unsigned int rectShader, unsigned int VAO, unsigned int controlTex) {
-    glUseProgram(rectShader);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, nameTexture);
-
+void addMyName(SpriteBatch& sprites) {
     const float NAME_SCALE = 0.4f;
     const float MARGIN = 0.05f;
     // Bottom-left corner calculation
     const float NAME_X = -1.0f + (NAME_SCALE / 2.0f) + MARGIN;
     const float NAME_Y = -1.0f + (NAME_SCALE / 2.0f) + MARGIN;
 
-    glUniform1f(glGetUniformLocation(rectShader, "uX"), NAME_X);
-    glUniform1f(glGetUniformLocation(rectShader, "uY"), NAME_Y);
-    glUniform1f(glGetUniformLocation(rectShader, "uS"), NAME_SCALE);
+    addSprite(sprites, atlas.regions[nameRegion], NAME_X, NAME_Y, NAME_SCALE, NAME_SCALE, SPRITE_LAYER_NAME);
+}
+
+// Svi spritovi frejma (ikone i ime) jednim pozivom crtanja
+void drawHud(ShaderProgram& spriteShader, SpriteBatch& sprites) {
+    PROFILE_FUNCTION();
+    unsigned long long drawStart = getMetricsClock();
+    useShaderProgram(spriteShader);
+    activeTextureUnit(0);
+    bindTexture2D(atlas.texture);
+    drawSpriteBatch(sprites);
+    recordHistogram(DRAW_HUD_METRIC, getMetricsClock() - drawStart);
+}
 
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+// Ulaz korisnika se snima (ako je snimanje ukljuceno) pa izvrsava nad simulacijom
+void handleInput(int type) {
+    recordInput(inputRecorder, sim, type);
+    applyInput(sim, type);
 }
 
 // Funkcija za obradu unosa sa tastature
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-    if (isWaiting) {
-        if (key == GLFW_KEY_K && action == GLFW_PRESS && !showControls) {
-            showControls = true;
-            if (passengersNumber != 0)
-			    punishmentNumber = rand() % passengersNumber;
-            passengersNumber++;
-            std::cout << "Broj putnika: " << passengersNumber << std::endl;
-        }
+    if (key == GLFW_KEY_K && action == GLFW_PRESS) {
+        handleInput(INPUT_CONTROL);
+    }
+
+    // F5: snimak celog stanja (nastavlja se sa --load-snapshot)
+    if (key == GLFW_KEY_F5 && action == GLFW_PRESS) {
+        saveSnapshot(snapshotPath, sim, eventDriven ? &scheduler : nullptr);
+    }
+
+    // F6: profil poslednjih frejmova (Chrome trace, otvara se u ui.perfetto.dev)
+    if (key == GLFW_KEY_F6 && action == GLFW_PRESS) {
+        PROFILE_DUMP(profilePath, profileFrames);
     }
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
-    if (isWaiting) {
-        if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS && passengersNumber < 50) {
-            passengersNumber++;
-            std::cout << "Broj putnika: " << passengersNumber << std::endl;
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
+        handleInput(INPUT_ADD_PASSENGER);
+    }
+
+    if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) {
+        handleInput(INPUT_REMOVE_PASSENGER);
+    }
+}
+
+// Merenja za --bench suite koja traze OpenGL: ucitavanje tekstura, crtanje putanje, stanica i
+// autobusa i crtanje mreza od 10 do 100K stanica u skrivenom prozoru. Posle svakog dela frejma je glFinish, pa uzorak sadrzi i rad GPU-a.
+const int BENCH_TEXTURE_LOADS = 20;
+const int BENCH_ATLAS_BUILDS = 5;
+const int BENCH_RENDER_BUSES[] = { 1, 100, 1000, 10000 };
+const int BENCH_STATION_COUNTS[] = { 10, 10000, 100000 };
+// Najvise frejmova po merenju; posle BENCH_RENDER_SECONDS se staje (ali ne pre BENCH_RENDER_MIN_FRAMES),
+// jer softversko crtanje (Mesa llvmpipe) hiljade autobusa crta sekundama
+const int BENCH_RENDER_FRAMES = 100;
+const int BENCH_RENDER_MIN_FRAMES = 5;
+const double BENCH_RENDER_SECONDS = 5.0;
+const int BENCH_WARMUP_STEPS = 600;   // Koraci pre crtanja, da se autobusi rasporede po putanji
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool hasRenderBudget(int frame, std::chrono::steady_clock::time_point start) {
+    if (frame >= BENCH_RENDER_FRAMES)
+        return false;
+    return frame < BENCH_RENDER_MIN_FRAMES || millisecondsSince(start) < BENCH_RENDER_SECONDS * 1e3;
+}
+
+// Stanice (bez linija) u kvadratnoj resetki preko celog ekrana, velicine jednog polja resetke
+// (najvise STATION_SCALE)
+float makeStationGrid(Network& grid, int numStations) {
+    int side = (int)ceil(sqrt((double)numStations));
+    float cell = 1.9f / side;
+    grid = Network();
+    grid.numStops = numStations;
+    grid.stopPositions.resize(2 * (size_t)numStations);
+    for (int i = 0; i < numStations; ++i) {
+        grid.stopPositions[2 * i] = -0.95f + cell * (i % side + 0.5f);
+        grid.stopPositions[2 * i + 1] = -0.95f + cell * (i / side + 0.5f);
+    }
+    markNetworkChanged(grid);
+    return cell < STATION_SCALE ? cell : STATION_SCALE;
+}
+
+// Stanice jedna po jedna (poziv crtanja po stanici) naspram jednog instanciranog poziva
+void benchmarkStationDraws(BenchmarkReport& report, unsigned int VAOrect, StationInstances& stations) {
+    for (int numStations : BENCH_STATION_COUNTS) {
+        Network grid;
+        float scale = makeStationGrid(grid, numStations);
+        updateStationInstances(stations, grid, scale);
+        std::string variant = "stations=" + std::to_string(numStations);
+
+        // Pozivi crtanja se broje u GlState.h, po frejmu
+        std::vector<double> oneByOneSamples, instancedSamples, oneByOneDraws, instancedDraws;
+        auto seriesStart = std::chrono::steady_clock::now();
+        for (int f = 0; hasRenderBudget(f, seriesStart); ++f) {
+            auto start = std::chrono::steady_clock::now();
+            glClear(GL_COLOR_BUFFER_BIT);
+            beginGlStateFrame();
+            drawStationsOneByOne(rectShader, VAOrect, grid.stopPositions.data(), numStations, scale);
+            endGlStateFrame();
+            glFinish();
+            oneByOneSamples.push_back(millisecondsSince(start));
+            oneByOneDraws.push_back((double)getGlStateDraws());
         }
+        seriesStart = std::chrono::steady_clock::now();
+        for (int f = 0; hasRenderBudget(f, seriesStart); ++f) {
+            auto start = std::chrono::steady_clock::now();
+            glClear(GL_COLOR_BUFFER_BIT);
+            beginGlStateFrame();
+            drawStations(stationShader, stations);
+            endGlStateFrame();
+            glFinish();
+            instancedSamples.push_back(millisecondsSince(start));
+            instancedDraws.push_back((double)getGlStateDraws());
+        }
+        addBenchmarkSeries(report, "stations_single", variant, "ms", oneByOneSamples);
+        addBenchmarkSeries(report, "stations_instanced", variant, "ms", instancedSamples);
+        addBenchmarkSeries(report, "draws_single", variant, "calls", oneByOneDraws);
+        addBenchmarkSeries(report, "draws_instanced", variant, "calls", instancedDraws);
+    }
+}
+
+bool runRenderBenchmarks(BenchmarkReport& report) {
+    if (!glfwInit()) {
+        std::cerr << "GLFW nije uspeo da se inicijalizuje." << std::endl;
+        return false;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(screenWidth, screenHeight, "Bus Project", NULL, NULL);
+    if (window == NULL) {
+        glfwTerminate();
+        std::cerr << "Prozor nije uspeo da se kreira." << std::endl;
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+    if (glewInit() != GLEW_OK) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        std::cerr << "GLEW nije uspeo da se inicijalizuje." << std::endl;
+        return false;
+    }
+    setBlend(true);
+    setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Ucitavanje tekstura: citanje i dekodiranje slike i slanje GPU-u
+    for (const char* path : ATLAS_IMAGES) {
+        std::vector<double> samples(BENCH_TEXTURE_LOADS);
+        for (int i = 0; i < BENCH_TEXTURE_LOADS; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            unsigned texture = loadImageToTexture(path);
+            glFinish();
+            samples[i] = millisecondsSince(start);
+            deleteTexture(texture);
+        }
+        addBenchmarkSeries(report, "texture_load", std::string("file=") + path, "ms", samples);
+    }
+
+    // Atlas: ucitavanje svih slika, pakovanje i slanje jedne teksture GPU-u
+    std::vector<double> atlasSamples(BENCH_ATLAS_BUILDS);
+    for (int i = 0; i < BENCH_ATLAS_BUILDS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        bool built = loadAtlas();
+        glFinish();
+        atlasSamples[i] = millisecondsSince(start);
+        if (!built) {
+            glfwDestroyWindow(window);
+            glfwTerminate();
+            return false;
+        }
+    }
+    addBenchmarkSeries(report, "atlas_build", "images=" + std::to_string(atlas.regions.size()), "ms", atlasSamples);
+
+    preprocessTexture(stationTexture, "res/busstation.jpeg");
+    if (!loadShaders()) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return false;
+    }
+
+    // Skriveni prozor nema vidljive piksele, pa se crta u poseban framebuffer iste velicine
+    unsigned int framebuffer, colorBuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, screenWidth, screenHeight);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glViewport(0, 0, screenWidth, screenHeight);
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 
-        if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS && passengersNumber > 0) {
-            passengersNumber--;
-            std::cout << "Broj putnika: " << passengersNumber << std::endl;
+    float verticesRect[] = { -0.5f, 0.5f, 0.0f, 1.0f, -0.5f, -0.5f, 0.0f, 0.0f, 0.5f, -0.5f, 1.0f, 0.0f, 0.5f, 0.5f, 1.0f, 1.0f };
+    unsigned int VAOrect;
+    formVAOTextured(verticesRect, sizeof(verticesRect), VAOrect);
+    StationInstances stations;
+    formVAOStations(stations, verticesRect, sizeof(verticesRect));
+    bool gpuTimers = initGpuTimers();
+    if (!gpuTimers)
+        std::cout << "GPU tajmeri nisu podrzani, merenja GPU-a preskocena" << std::endl;
+
+    for (int buses : BENCH_RENDER_BUSES) {
+        Simulation benchSim;
+        Network network;
+        makeLoopNetwork(network, NUM_STATIONS, ROUTE_AXIS_A, ROUTE_AXIS_B);
+        SimulationConfig config;
+        config.numBuses = buses;
+        initSimulation(benchSim, network, config);
+        for (int t = 0; t < BENCH_WARMUP_STEPS; ++t)
+            stepSimulation(benchSim, SIMULATION_STEP_SECONDS);
+        FleetInstances fleetInstances;
+        formVAOFleet(fleetInstances, verticesRect, sizeof(verticesRect), benchSim.fleet.size, true);
+
+        unsigned int VAOpath;
+        const std::vector<float>& pathVertices = benchSim.route.points;
+        formVAOPosition(pathVertices, pathVertices.size() * sizeof(float), VAOpath);
+        std::vector<int> pathFirst(benchSim.route.segmentOffsets.begin(), benchSim.route.segmentOffsets.end() - 1);
+        std::vector<int> pathCount(benchSim.route.numSegments);
+        for (int i = 0; i < benchSim.route.numSegments; ++i)
+            pathCount[i] = benchSim.route.segmentOffsets[i + 1] - benchSim.route.segmentOffsets[i];
+
+        updateStationInstances(stations, benchSim.network, STATION_SCALE);
+        std::vector<double> pathSamples, stationSamples, busSamples, frameSamples;
+        std::vector<double> gpuPathSamples, gpuStationSamples, gpuBusSamples;
+        std::vector<double> issuedSamples, elidedSamples, drawSamples;
+        auto seriesStart = std::chrono::steady_clock::now();
+        for (int f = 0; hasRenderBudget(f, seriesStart); ++f) {
+            auto frameStart = std::chrono::steady_clock::now();
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            beginGpuFrame();
+            beginGlStateFrame();
+
+            auto start = std::chrono::steady_clock::now();
+            beginGpuTimer(GPU_PASS_PATH);
+            drawPath(colorShader, VAOpath, pathFirst.data(), pathCount.data(), benchSim.route.numSegments);
+            endGpuTimer();
+            glFinish();
+            pathSamples.push_back(millisecondsSince(start));
+
+            start = std::chrono::steady_clock::now();
+            beginGpuTimer(GPU_PASS_STATIONS);
+            drawStations(stationShader, stations);
+            endGpuTimer();
+            glFinish();
+            stationSamples.push_back(millisecondsSince(start));
+
+            start = std::chrono::steady_clock::now();
+            beginGpuTimer(GPU_PASS_BUS);
+            updateFleetInstances(fleetInstances, benchSim.fleet, benchSim.route);
+            drawFleet(busShader, fleetInstances);
+            endGpuTimer();
+            glFinish();
+            busSamples.push_back(millisecondsSince(start));
+            frameSamples.push_back(millisecondsSince(frameStart));
+            endGlStateFrame();
+            issuedSamples.push_back((double)getGlStateIssued());
+            elidedSamples.push_back((double)getGlStateElided());
+            drawSamples.push_back((double)getGlStateDraws());
+
+            // Posle glFinish su rezultati ovog frejma dostupni
+            collectGpuTimers();
+            if (gpuTimers) {
+                gpuPathSamples.push_back(getGpuTimerSeconds(GPU_PASS_PATH) * 1e3);
+                gpuStationSamples.push_back(getGpuTimerSeconds(GPU_PASS_STATIONS) * 1e3);
+                gpuBusSamples.push_back(getGpuTimerSeconds(GPU_PASS_BUS) * 1e3);
+            }
         }
+        std::string variant = "buses=" + std::to_string(buses);
+        addBenchmarkSeries(report, "render_path", variant, "ms", pathSamples);
+        addBenchmarkSeries(report, "render_stations", variant, "ms", stationSamples);
+        addBenchmarkSeries(report, "render_buses", variant, "ms", busSamples);
+        addBenchmarkSeries(report, "render_frame", variant, "ms", frameSamples);
+        addBenchmarkSeries(report, "gl_issued", variant, "calls", issuedSamples);
+        addBenchmarkSeries(report, "gl_elided", variant, "calls", elidedSamples);
+        addBenchmarkSeries(report, "gl_draws", variant, "calls", drawSamples);
+        if (gpuTimers) {
+            addBenchmarkSeries(report, "gpu_path", variant, "ms", gpuPathSamples);
+            addBenchmarkSeries(report, "gpu_stations", variant, "ms", gpuStationSamples);
+            addBenchmarkSeries(report, "gpu_buses", variant, "ms", gpuBusSamples);
+        }
+        deleteVertexArray(VAOpath);
+        destroyFleetInstances(fleetInstances);
     }
+    benchmarkStationDraws(report, VAOrect, stations);
+
+    destroyGpuTimers();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    deleteVertexArray(VAOrect);
+    destroyStationInstances(stations);
+    destroyTextureAtlas(atlas);
+    deleteTexture(stationTexture);
+    destroyShaderProgram(rectShader);
+    destroyShaderProgram(colorShader);
+    destroyShaderProgram(stationShader);
+    destroyShaderProgram(busShader);
+    destroyShaderProgram(spriteShader);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return true;
 }
 
 
-int main()
+int main(int argc, char** argv)
 {
+    // Rad bez prozora: simulacija se izvrsava najbrze sto moze, bez GLFW/GLEW-a
+    if (hasArgument(argc, argv, "--headless"))
+        return runHeadless(argc, argv);
+    if (hasArgument(argc, argv, "--bench"))
+        return runBenchmark(argc, argv, runRenderBenchmarks);
+    if (hasArgument(argc, argv, "--replay"))
+        return runReplay(argc, argv);
+    if (hasArgument(argc, argv, "--format-log"))
+        return formatLog(getArgument(argc, argv, "--format-log", ""));
+    if (hasArgument(argc, argv, "--format-telemetry"))
+        return formatTelemetry(getArgument(argc, argv, "--format-telemetry", ""));
+
     // GLFW, GLEW, GL_BLEND inicijalizacija
     if (!glfwInit()) return endProgram("GLFW nije uspeo da se inicijalizuje.");
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -258,107 +764,138 @@ int main()
     if (window == NULL) return endProgram("Prozor nije uspeo da se kreira.");
     glfwMakeContextCurrent(window);
     if (glewInit() != GLEW_OK) return endProgram("GLEW nije uspeo da se inicijalizuje.");
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    setBlend(true);
+    setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	GLFWcursor* cursor = loadImageToCursor("res/pointer.png");
     glfwSetCursor(window, cursor);
 
-    srand(time(NULL));
     glfwSetKeyCallback(window, key_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
 
     // --- UITAVANJE TEKSTURA I EJDERA ---
-    preprocessTexture(busTexture, "res/avtobus.png");
-    preprocessTexture(stationTexture, "res/busstation.jpeg");
-    preprocessTexture(closedIconTexture, "res/zatvorena.png");
-    preprocessTexture(openIconTexture, "res/otvorena.png");
-    preprocessTexture(controlIconTexture, "res/kontrola.png");
-    preprocessTexture(nameTexture, "res/ime.png");
-
-    rectShader = createShader("rect.vert", "rect.frag");
-    glUseProgram(rectShader);
-    glUniform1i(glGetUniformLocation(rectShader, "uTex0"), 0);
+    if (!loadAtlas()) return endProgram("Atlas slika nije uspeo da se napravi.");
+    std::cout << "Atlas: " << atlas.width << "x" << atlas.height << ", " << atlas.regions.size() << " slika" << std::endl;
 
-    colorShader = createShader("color.vert", "color.frag");
+    if (!loadShaders()) return endProgram("Sejderi nisu uspeli da se ucitaju.");
 
     // --- DEFINICIJA KOORDINATA ---
-    const int NUM_STATIONS = 10;
     float verticesBus[] = { -0.5f, 0.5f, 0.0f, 1.0f, -0.5f, -0.5f, 0.0f, 0.0f, 0.5f, -0.5f, 1.0f, 0.0f, 0.5f, 0.5f, 1.0f, 1.0f };
     float verticesStation[] = { -0.5f, 0.5f, 0.0f, 1.0f, -0.5f, -0.5f, 0.0f, 0.0f, 0.5f, -0.5f, 1.0f, 0.0f, 0.5f, 0.5f, 1.0f, 1.0f };
 
 
-    // Koordinate 10 stanica
-    float stationPositions[NUM_STATIONS * 2];
-    float a = 0.8f; // Poluosa a (x)
-    float b = 0.5f; // Poluosa b (y)
-
-    for (int i = 0; i < NUM_STATIONS; ++i) {
-        float angle = i * 2 * M_PI / NUM_STATIONS;
-        stationPositions[2 * i] = cos(angle) * a;
-        stationPositions[2 * i + 1] = sin(angle) * b;
+    eventDriven = hasArgument(argc, argv, "--events");
+    setGlStateCache(!hasArgument(argc, argv, "--no-state-cache"));
+    snapshotPath = getArgument(argc, argv, "--snapshot", snapshotPath);
+    bool profileAtExit = hasArgument(argc, argv, "--profile");
+    profilePath = getArgument(argc, argv, "--profile", profilePath);
+    profileFrames = (int)getArgumentInt(argc, argv, "--profile-frames", PROFILE_DEFAULT_FRAMES);
+    PROFILE_THREAD("glavna");
+
+    // Pocetno stanje sesije (zapisuje se u snimak ulaza)
+    InputLog session;
+    session.eventDriven = eventDriven;
+
+    // --load-snapshot: nastavlja se snimljena simulacija umesto nove
+    const char* loadPath = getArgument(argc, argv, "--load-snapshot", nullptr);
+    if (loadPath != nullptr) {
+        if (!loadSnapshot(loadPath, sim, eventDriven ? &scheduler : nullptr))
+            return endProgram("Snimak nije uspeo da se ucita.");
+        session.source = INPUT_SOURCE_SNAPSHOT;
+        session.sourcePath = loadPath;
     }
+    else {
+        // Broj autobusa, putnika i kontrolora, seme
+        SimulationConfig& config = session.config;
+        if (!getSimulationConfig(argc, argv, config))
+            return endProgram("Neispravni parametri simulacije.");
+        session.sourcePath = getArgument(argc, argv, "--network", "");
+
+        // Stanice i linije (--network <fajl>, inace 10 stanica na elipsi)
+        Network network;
+        if (!getNetworkArgument(argc, argv, network))
+            return endProgram("Mreza nije uspela da se ucita.");
+        initSimulation(sim, network, config);
+        if (eventDriven)
+            initEventScheduler(scheduler, sim);
+    }
+    // --- FORMIRANJE VAO-ova ---
+    // Pre snimanja ulaza, dnevnika, telemetrije i servera metrika, da greska ovde ne bi prekinula
+    // program dok njihove niti rade i dok snimak ulaza nije zavrsen
 
-    std::vector<float> pathVertices;
-    const int CURVE_POINTS_PER_SEGMENT = 5; // broj taaka izmeu dve stanice
-    const float WIGGLE_RANGE = 0.08f;
-
-    // Prolazimo kroz 10 segmenata (od Stanice i do Stanice i+1)
-    for (int i = 0; i < NUM_STATIONS; ++i) {
-
-        float x1 = stationPositions[2 * i];
-        float y1 = stationPositions[2 * i + 1];
-
-		float x2 = stationPositions[2 * ((i + 1) % NUM_STATIONS)]; // modul za povratak na prvu stanicu
-        float y2 = stationPositions[2 * ((i + 1) % NUM_STATIONS) + 1];
-
-        pathVertices.push_back(x1);
-        pathVertices.push_back(y1);
-
-		// Dodavanje krivudavih taaka izmeu dve stanice
-        for (int j = 1; j < CURVE_POINTS_PER_SEGMENT; ++j) {
+    StationInstances stations;
+    formVAOStations(stations, verticesStation, sizeof(verticesStation));
 
-            // Faktor interpolacije (t ide od 0 do 1)
-            float t = (float)j / CURVE_POINTS_PER_SEGMENT;
+    // Tok instanci flote: trajno mapiran bafer ako ga GL podrzava (--no-persistent-map: orphaning)
+    FleetInstances fleetInstances;
+    if (!formVAOFleet(fleetInstances, verticesBus, sizeof(verticesBus), sim.fleet.size, !hasArgument(argc, argv, "--no-persistent-map"))) {
+        destroyStationInstances(stations);
+        return endProgram("Bafer flote nije uspeo da se napravi.");
+    }
+    std::cout << "Bafer flote: " << (fleetInstances.stream.persistent ? "trajno mapiran" : "orphaning") << std::endl;
+
+    // Ikone i ime se skupljaju u frejmu i crtaju jednim pozivom
+    SpriteBatch hudSprites;
+    if (!createSpriteBatch(hudSprites, HUD_SPRITES, !hasArgument(argc, argv, "--no-persistent-map"))) {
+        destroyFleetInstances(fleetInstances);
+        destroyStationInstances(stations);
+        return endProgram("Bafer spritova nije uspeo da se napravi.");
+    }
 
-            // Linearna interpolacija (taka na ravnoj liniji)
-            float interX = x1 * (1.0f - t) + x2 * t;
-            float interY = y1 * (1.0f - t) + y2 * t;
+    const char* recordPath = getArgument(argc, argv, "--record", nullptr);
+    if (recordPath != nullptr && !startInputRecording(inputRecorder, recordPath, session))
+        return endProgram("Snimanje ulaza nije uspelo da pocne.");
 
-            // Dodavanje nasuminog pomeraja (WIGGLE)
-            float wiggleFactor = sin(t * M_PI);
-            float wiggleX = randomOffset(WIGGLE_RANGE * wiggleFactor);
-            float wiggleY = randomOffset(WIGGLE_RANGE * wiggleFactor);
+    // Ulasci, izlasci, kontrole i klikovi idu u dnevnik umesto na konzolu (citljiv ispis: --format-log)
+    if (!startLog(getArgument(argc, argv, "--log", "autobus.log")))
+        return endProgram("Dnevnik nije uspeo da se otvori.");
 
-            pathVertices.push_back(interX + wiggleX);
-            pathVertices.push_back(interY + wiggleY);
-        }
+    // --telemetry: stanje flote posle frejma, najvise jednom u --telemetry-interval sekundi
+    const char* telemetryPath = getArgument(argc, argv, "--telemetry", nullptr);
+    double telemetryInterval = getArgumentDouble(argc, argv, "--telemetry-interval", TELEMETRY_INTERVAL_SECONDS);
+    if (telemetryPath != nullptr && (telemetryInterval <= 0.0 || !startTelemetry(telemetryPath, sim.fleet.size, telemetryInterval, false))) {
+        stopLog();
+        return endProgram("Telemetrija nije uspela da se pokrene.");
     }
 
-    // --- FORMIRANJE VAO-ova ---
-    unsigned int VAObus;
-    formVAOTextured(verticesBus, sizeof(verticesBus), VAObus);
-
-    unsigned int VAOstation;
-    formVAOTextured(verticesStation, sizeof(verticesStation), VAOstation);
+    // --metrics <fajl> (osvezava se u toku rada), --metrics-port <port> (HTTP na 127.0.0.1)
+    const char* metricsPath = getArgument(argc, argv, "--metrics", nullptr);
+    int metricsPort = (int)getArgumentInt(argc, argv, "--metrics-port", 0);
+    if (metricsPort > 0 && !startMetricsServer(metricsPort)) {
+        stopTelemetry();
+        stopLog();
+        return endProgram("Server metrika nije uspeo da se pokrene.");
+    }
 
     unsigned int VAOpath;
+    // Putanju (krivudave tacke izmedju stanica) pravi simulacija, jer je autobusi prate
+    const std::vector<float>& pathVertices = sim.route.points;
     size_t pathDataSize = pathVertices.size() * sizeof(float);
     formVAOPosition(pathVertices, pathDataSize, VAOpath);
-    int totalPathPoints = pathVertices.size() / 2;
+    std::vector<int> pathFirst(sim.route.segmentOffsets.begin(), sim.route.segmentOffsets.end() - 1);
+    std::vector<int> pathCount(sim.route.numSegments);
+    for (int i = 0; i < sim.route.numSegments; ++i)
+        pathCount[i] = sim.route.segmentOffsets[i + 1] - sim.route.segmentOffsets[i];
 
-    // --- POZICIJA AUTOBUSA ---
-    // Postavljamo autobus na prvu stanicu na putanji
-    float busX = stationPositions[0];
-    float busY = stationPositions[1];
+    // GPU tajmeri delova crtanja (ako ih GL nema, merenje se preskace)
+    if (!initGpuTimers())
+        std::cout << "GPU tajmeri nisu podrzani." << std::endl;
 
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     lastTime = glfwGetTime();
+    double nextMetricsDump = lastTime;
 
     // Glavna render petlja
     while (!glfwWindowShouldClose(window))
     {
-        glfwPollEvents();
+        PROFILE_FRAME();
+        PROFILE_SCOPE("frame");
+        beginGpuFrame();
+        beginGlStateFrame();
+        {
+            PROFILE_SCOPE("glfwPollEvents");
+            glfwPollEvents();
+        }
         glClear(GL_COLOR_BUFFER_BIT);
 
         // 1. IZRAUNAVANJE VREMENA (DeltaTime)
@@ -366,73 +903,79 @@ int main()
         float deltaTime = (float)(currentTime - lastTime); // Vreme proteklo od proslog frejma
         lastTime = currentTime;
 
-        // 2. LOGIKA KRETANJA I STAJANJA
-        if (isWaiting) {
-            waitTimer += deltaTime;
-            if (waitTimer >= STATION_WAIT_SECONDS) {
-                isWaiting = false;
-                currentSegmentTime = 0.0f; // reset
-                waitTimer = 0.0f;
-				currentStationIndex = (currentStationIndex + 1) % NUM_STATIONS; // Sledea stanica
-            }
+        addCounter(FRAMES_METRIC, 1);
+        recordHistogram(FRAME_SECONDS_METRIC, (unsigned long long)(deltaTime * 1e9));
+
+        // 2. LOGIKA KRETANJA I STAJANJA (fiksni koraci simulacije)
+        {
+            PROFILE_SCOPE("simulation");
+            unsigned long long simulationStart = getMetricsClock();
+            if (eventDriven)
+                advanceEvents(scheduler, sim, deltaTime, nullptr);
+            else
+                advanceSimulation(sim, stepAccumulator, deltaTime);
+            recordTelemetry(sim);
+            updateFleetInstances(fleetInstances, sim.fleet, sim.route);
+            recordHistogram(FRAME_SIMULATION_METRIC, getMetricsClock() - simulationStart);
         }
-        else {
-            // --- LOGIKA PUTOVANJA ---
-            currentSegmentTime += deltaTime;
-            float t = currentSegmentTime / TRAVEL_TIME_SECONDS;
-
-            if (t >= 1.0f) {
-                // Stigli smo do sledece stanice!
-                if (showControls) {
-					passengersNumber -= punishmentNumber + 1;
-                    std::cout << "Kazna zbog kontrole: " << punishmentNumber << " putnika." << std::endl;
-                    std::cout << "Broj putnika nakon kazne: " << passengersNumber << std::endl;
-                    showControls = false;
-					punishmentNumber = 0;
-				}
-                t = 1.0f; 
-                isWaiting = true;
-            }
-
-            // Polazna stanica (A)
-            int startIdx = ((currentStationIndex - 1 + NUM_STATIONS) % NUM_STATIONS) * 2;
-            float xA = stationPositions[startIdx];
-            float yA = stationPositions[startIdx + 1];
 
-            // Odredisna stanica (B)
-            int endIdx = currentStationIndex * 2;
-            float xB = stationPositions[endIdx];
-            float yB = stationPositions[endIdx + 1];
-
-            busX = xA * (1.0f - t) + xB * t;
-            busY = yA * (1.0f - t) + yB * t;
+        // --metrics: fajl se osvezava jednom u METRICS_DUMP_SECONDS
+        if (metricsPath != nullptr && currentTime >= nextMetricsDump) {
+            PROFILE_SCOPE("dumpMetrics");
+            updateSimulationMetrics(sim);
+            dumpMetrics(metricsPath);
+            nextMetricsDump = currentTime + METRICS_DUMP_SECONDS;
         }
 
-        // Crtanje putanje, stanica i autobusa
-        drawPath(colorShader, VAOpath, totalPathPoints);
-        drawStations(rectShader, VAOstation, stationPositions, NUM_STATIONS);
-        drawBus(rectShader, VAObus, busX, busY);
-        drawStatusIcon(rectShader, VAObus, closedIconTexture, openIconTexture, isWaiting);
-        if (showControls) {
-            drawControlIcon(rectShader, VAObus, controlIconTexture);
+        // Crtanje putanje, stanica i autobusa (svaki deo meri i GPU tajmer)
+        beginGpuTimer(GPU_PASS_PATH);
+        drawPath(colorShader, VAOpath, pathFirst.data(), pathCount.data(), sim.route.numSegments);
+        endGpuTimer();
+        beginGpuTimer(GPU_PASS_STATIONS);
+        updateStationInstances(stations, sim.network, STATION_SCALE);
+        drawStations(stationShader, stations);
+        endGpuTimer();
+        {
+            PROFILE_SCOPE("drawBuses");
+            beginGpuTimer(GPU_PASS_BUS);
+            drawFleet(busShader, fleetInstances);
+            endGpuTimer();
         }
-		drawMyName(rectShader, VAObus, nameTexture);
-
+        beginGpuTimer(GPU_PASS_HUD);
+        addStatusIcon(hudSprites, isPlayerBusWaiting(sim));
+        if (isPlayerBusInspected(sim))
+            addControlIcon(hudSprites);
+        addMyName(hudSprites);
+        drawHud(spriteShader, hudSprites);
+        endGpuTimer();
+        endGlStateFrame();
+
+        PROFILE_SCOPE("glfwSwapBuffers");
         glfwSwapBuffers(window);
     }
 
     // ienje
-    glDeleteProgram(rectShader);
-    glDeleteProgram(colorShader);
-    glDeleteVertexArrays(1, &VAObus);
-    glDeleteVertexArrays(1, &VAOstation);
-    glDeleteVertexArrays(1, &VAOpath);
-    glDeleteTextures(1, &busTexture);
-    glDeleteTextures(1, &stationTexture);
-    glDeleteTextures(1, &closedIconTexture);
-	glDeleteTextures(1, &openIconTexture);
-	glDeleteTextures(1, &controlIconTexture);
-    glDeleteTextures(1, &nameTexture);
+    destroyGpuTimers();
+    destroyShaderProgram(rectShader);
+    destroyShaderProgram(colorShader);
+    destroyShaderProgram(stationShader);
+    destroyShaderProgram(busShader);
+    destroyShaderProgram(spriteShader);
+    destroyStationInstances(stations);
+    destroyFleetInstances(fleetInstances);
+    destroySpriteBatch(hudSprites);
+    deleteVertexArray(VAOpath);
+    destroyTextureAtlas(atlas);
+    finishInputRecording(inputRecorder, sim);
+    stopLog();
+    stopTelemetry();
+    stopMetricsServer();
+    if (metricsPath != nullptr) {
+        updateSimulationMetrics(sim);
+        dumpMetrics(metricsPath);
+    }
+    if (profileAtExit)
+        PROFILE_DUMP(profilePath, profileFrames);
     glfwDestroyWindow(window);
     glfwTerminate();
     return 0;
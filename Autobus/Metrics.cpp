@@ -0,0 +1,325 @@
+#include "Metrics.h"
+#include "Bits.h"
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <windows.h>
+#pragma comment(lib, "Ws2_32.lib")
+typedef SOCKET MetricsSocket;
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int MetricsSocket;
+const MetricsSocket INVALID_SOCKET = -1;
+static int closesocket(MetricsSocket socket) { return close(socket); }
+#endif
+
+// Koliko dugo server ceka zahtev pre nego sto proveri da li treba da stane
+const int METRICS_SERVER_POLL_MILLISECONDS = 100;
+// Koliko provera klijent ima da posalje zahtev posle povezivanja (ukupno jedna sekunda)
+const int METRICS_CLIENT_POLLS = 10;
+
+// Metrika u registru; korpe histograma postoje za sve metrike (registar je staticki, bez zauzimanja)
+struct MetricSlot {
+    int kind;
+    const char* name;
+    const char* labels;
+    const char* help;
+    double scale;
+    std::atomic<long long> counter;
+    std::atomic<double> gauge;
+    std::atomic<unsigned long long> sum;
+    std::atomic<unsigned long long> buckets[HISTOGRAM_BUCKETS];
+};
+
+static MetricSlot metrics[METRICS_MAX];
+static std::atomic<int> metricCount(0);
+
+int registerMetric(int kind, const char* name, const char* labels, const char* help, double scale) {
+    int metric = metricCount.fetch_add(1);
+    if (metric >= METRICS_MAX) {
+        metricCount = METRICS_MAX;
+        return -1;
+    }
+    MetricSlot& slot = metrics[metric];
+    slot.kind = kind;
+    slot.name = name;
+    slot.labels = labels;
+    slot.help = help;
+    slot.scale = scale;
+    return metric;
+}
+
+int findMetric(const char* name, const char* labels) {
+    int count = metricCount.load();
+    for (int m = 0; m < count; ++m) {
+        const MetricSlot& slot = metrics[m];
+        bool sameLabels = slot.labels == nullptr || labels == nullptr ? slot.labels == labels : strcmp(slot.labels, labels) == 0;
+        if (strcmp(slot.name, name) == 0 && sameLabels)
+            return m;
+    }
+    return -1;
+}
+
+void addCounter(int metric, long long value) {
+    if (metric >= 0)
+        metrics[metric].counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+void setGauge(int metric, double value) {
+    if (metric >= 0)
+        metrics[metric].gauge.store(value, std::memory_order_relaxed);
+}
+
+// Korpa vrednosti: ispod HISTOGRAM_SUB_BUCKETS tacno, iznad toga stepen dvojke i gornji bitovi ispod njega
+static inline int getHistogramBucket(unsigned long long value) {
+    if (value < (unsigned long long)HISTOGRAM_SUB_BUCKETS)
+        return (int)value;
+    int exponent = highestSetBit(value);
+    int sub = (int)(value >> (exponent - HISTOGRAM_SUB_BUCKET_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return (exponent - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+// Najveca vrednost koja upada u korpu
+static unsigned long long getBucketUpperBound(int bucket) {
+    if (bucket < HISTOGRAM_SUB_BUCKETS)
+        return (unsigned long long)bucket;
+    int shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+    unsigned long long lower = (unsigned long long)(HISTOGRAM_SUB_BUCKETS + bucket % HISTOGRAM_SUB_BUCKETS) << shift;
+    return lower + ((1ULL << shift) - 1);
+}
+
+void recordHistogram(int metric, unsigned long long value) {
+    if (metric < 0)
+        return;
+    MetricSlot& slot = metrics[metric];
+    slot.buckets[getHistogramBucket(value)].fetch_add(1, std::memory_order_relaxed);
+    slot.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+unsigned long long getMetricsClock() {
+    return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+long long getHistogramCount(int metric) {
+    if (metric < 0)
+        return 0;
+    long long count = 0;
+    for (int b = 0; b < HISTOGRAM_BUCKETS; ++b)
+        count += (long long)metrics[metric].buckets[b].load(std::memory_order_relaxed);
+    return count;
+}
+
+double getHistogramPercentile(int metric, double percent) {
+    long long count = getHistogramCount(metric);
+    if (count == 0)
+        return 0.0;
+    const MetricSlot& slot = metrics[metric];
+    long long target = (long long)(percent / 100.0 * count + 0.5);
+    target = target < 1 ? 1 : target;
+    long long seen = 0;
+    for (int b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+        seen += (long long)slot.buckets[b].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return getBucketUpperBound(b) * slot.scale;
+    }
+    return getBucketUpperBound(HISTOGRAM_BUCKETS - 1) * slot.scale;
+}
+
+static void appendLine(std::string& text, const char* format, ...) {
+    char line[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    text += line;
+}
+
+// Ime sa oznakama: name{labels,extra}
+static std::string getSeriesName(const MetricSlot& slot, const char* suffix, const char* extra) {
+    std::string series = slot.name;
+    series += suffix;
+    bool hasLabels = slot.labels != nullptr && slot.labels[0] != '\0';
+    if (hasLabels || extra != nullptr) {
+        series += '{';
+        if (hasLabels)
+            series += slot.labels;
+        if (hasLabels && extra != nullptr)
+            series += ',';
+        if (extra != nullptr)
+            series += extra;
+        series += '}';
+    }
+    return series;
+}
+
+// Histogram u Prometheus-u: zbirne korpe na granicama stepena dvojke (do najvece zauzete), zbir i broj
+static void appendHistogram(std::string& text, const MetricSlot& slot) {
+    unsigned long long counts[HISTOGRAM_BUCKETS];
+    int last = -1;
+    for (int b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+        counts[b] = slot.buckets[b].load(std::memory_order_relaxed);
+        if (counts[b] != 0)
+            last = b;
+    }
+    unsigned long long cumulative = 0;
+    int bucket = 0;
+    int maxExponent = last < 0 ? 0 : highestSetBit(getBucketUpperBound(last) | 1) + 1;
+    maxExponent = maxExponent < 63 ? maxExponent : 63;
+    for (int exponent = 0; exponent <= maxExponent; ++exponent) {
+        // Korpe cije su sve vrednosti najvise 2^exponent
+        while (bucket < HISTOGRAM_BUCKETS && getBucketUpperBound(bucket) <= (1ULL << exponent))
+            cumulative += counts[bucket++];
+        char le[64];
+        snprintf(le, sizeof(le), "le=\"%.9g\"", (double)(1ULL << exponent) * slot.scale);
+        appendLine(text, "%s %llu\n", getSeriesName(slot, "_bucket", le).c_str(), cumulative);
+    }
+    while (bucket < HISTOGRAM_BUCKETS)
+        cumulative += counts[bucket++];
+    appendLine(text, "%s %llu\n", getSeriesName(slot, "_bucket", "le=\"+Inf\"").c_str(), cumulative);
+    appendLine(text, "%s %.9g\n", getSeriesName(slot, "_sum", nullptr).c_str(),
+        (double)slot.sum.load(std::memory_order_relaxed) * slot.scale);
+    appendLine(text, "%s %llu\n", getSeriesName(slot, "_count", nullptr).c_str(), cumulative);
+}
+
+std::string formatMetrics() {
+    static const char* const typeNames[] = { "counter", "gauge", "histogram" };
+    std::string text;
+    int count = metricCount.load();
+    for (int m = 0; m < count; ++m) {
+        const MetricSlot& slot = metrics[m];
+        if (m == 0 || strcmp(metrics[m - 1].name, slot.name) != 0) {
+            appendLine(text, "# HELP %s %s\n", slot.name, slot.help);
+            appendLine(text, "# TYPE %s %s\n", slot.name, typeNames[slot.kind]);
+        }
+        if (slot.kind == METRIC_COUNTER)
+            appendLine(text, "%s %lld\n", getSeriesName(slot, "", nullptr).c_str(), slot.counter.load(std::memory_order_relaxed));
+        else if (slot.kind == METRIC_GAUGE)
+            appendLine(text, "%s %.9g\n", getSeriesName(slot, "", nullptr).c_str(), slot.gauge.load(std::memory_order_relaxed));
+        else
+            appendHistogram(text, slot);
+    }
+    return text;
+}
+
+bool dumpMetrics(const char* path) {
+    std::string text = formatMetrics();
+    std::string temporary = std::string(path) + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Greska pri upisu metrika u \"" << path << "\"!" << std::endl;
+        return false;
+    }
+    bool written = fwrite(text.data(), 1, text.size(), file) == text.size();
+    written = fclose(file) == 0 && written;
+#ifdef _WIN32
+    written = written && MoveFileExA(temporary.c_str(), path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    written = written && rename(temporary.c_str(), path) == 0;
+#endif
+    if (!written)
+        std::cerr << "Greska pri upisu metrika u \"" << path << "\"!" << std::endl;
+    return written;
+}
+
+static std::atomic<bool> serverRunning(false);
+static std::thread serverThread;
+static MetricsSocket serverSocket = INVALID_SOCKET;
+
+// Ceka najvise METRICS_SERVER_POLL_MILLISECONDS da socket ima nesto za citanje
+static bool waitReadable(MetricsSocket socket) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(socket, &readable);
+    timeval timeout = { 0, METRICS_SERVER_POLL_MILLISECONDS * 1000 };
+    return select((int)socket + 1, &readable, nullptr, nullptr, &timeout) > 0;
+}
+
+// Na svaki zahtev (bilo koja putanja) odgovara trenutnim metrikama i zatvara vezu
+static void runMetricsServer() {
+    while (serverRunning.load()) {
+        if (!waitReadable(serverSocket))
+            continue;
+        MetricsSocket client = accept(serverSocket, nullptr, nullptr);
+        if (client == INVALID_SOCKET)
+            continue;
+
+        // Klijent koji se poveze a ne posalje zahtev se odbacuje, da ne blokira nit (i stopMetricsServer)
+        bool readable = false;
+        for (int poll = 0; poll < METRICS_CLIENT_POLLS && !readable && serverRunning.load(); ++poll)
+            readable = waitReadable(client);
+        char request[4096];
+        if (!readable || recv(client, request, sizeof(request), 0) <= 0) {
+            closesocket(client);
+            continue;
+        }
+        std::string body = formatMetrics();
+        std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+            + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            int result = send(client, response.data() + sent, (int)(response.size() - sent), 0);
+            if (result <= 0)
+                break;
+            sent += result;
+        }
+        closesocket(client);
+    }
+}
+
+bool startMetricsServer(int port) {
+    stopMetricsServer();
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        return false;
+#endif
+    serverSocket = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (serverSocket == INVALID_SOCKET || bind(serverSocket, (const sockaddr*)&address, sizeof(address)) != 0
+        || listen(serverSocket, 4) != 0) {
+        std::cerr << "Server metrika ne moze da slusa na portu " << port << "!" << std::endl;
+        if (serverSocket != INVALID_SOCKET)
+            closesocket(serverSocket);
+        serverSocket = INVALID_SOCKET;
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    serverRunning = true;
+    serverThread = std::thread(runMetricsServer);
+    std::cout << "Metrike: http://127.0.0.1:" << port << "/metrics" << std::endl;
+    return true;
+}
+
+void stopMetricsServer() {
+    if (!serverRunning.load())
+        return;
+    serverRunning = false;
+    serverThread.join();
+    closesocket(serverSocket);
+    serverSocket = INVALID_SOCKET;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
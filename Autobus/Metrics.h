@@ -0,0 +1,58 @@
+#pragma once
+#include <string>
+
+// Metrike rada programa (trajanje frejma, koraka simulacije i crtanja, ulasci i izlasci po
+// stanici...): brojaci, merila i histogrami, ispisani u tekstualnom formatu Prometheus-a u fajl
+// (--metrics <fajl>) ili na lokalnoj HTTP adresi (--metrics-port <port>, http://127.0.0.1:<port>/metrics).
+//
+// Metrike se registruju jednom (obicno pri pokretanju, iz staticke promenljive modula koji ih meri),
+// a upis vrednosti je jedno atomsko sabiranje bez zakljucavanja, pa merenje ostaje ukljuceno i u
+// normalnom radu. Histogram je logaritamski (kao HDR histogram): vrednosti do
+// HISTOGRAM_SUB_BUCKETS su tacne, a iznad toga svaki stepen dvojke je podeljen na
+// HISTOGRAM_SUB_BUCKETS jednakih delova, pa je greska najvise 1/16 vrednosti za ceo opseg 64-bitnih
+// vrednosti.
+
+enum MetricKind {
+    METRIC_COUNTER,      // Samo raste (addCounter)
+    METRIC_GAUGE,        // Trenutna vrednost (setGauge)
+    METRIC_HISTOGRAM     // Raspodela vrednosti (recordHistogram)
+};
+
+// Najvise registrovanih metrika
+const int METRICS_MAX = 64;
+
+// Podela histograma: HISTOGRAM_SUB_BUCKETS delova po stepenu dvojke
+const int HISTOGRAM_SUB_BUCKET_BITS = 4;
+const int HISTOGRAM_SUB_BUCKETS = 1 << HISTOGRAM_SUB_BUCKET_BITS;
+const int HISTOGRAM_BUCKETS = (64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS;
+
+// Registruje metriku i vraca njen broj (-1 ako je registar pun). Metrike istog imena sa razlicitim
+// oznakama (labels, npr. "pass=\"path\"", ili nullptr) cine jednu familiju i registruju se jedna
+// za drugom. Vrednosti histograma se pri ispisu mnoze sa scale (npr. 1e-9 za nanosekunde u sekunde).
+int registerMetric(int kind, const char* name, const char* labels, const char* help, double scale = 1.0);
+
+// Broj registrovane metrike sa datim imenom i oznakama (nullptr: bez oznaka), -1 ako je nema
+int findMetric(const char* name, const char* labels);
+
+// Upis vrednosti (bez zakljucavanja, iz bilo koje niti)
+void addCounter(int metric, long long value);
+void setGauge(int metric, double value);
+void recordHistogram(int metric, unsigned long long value);
+
+// Monotono vreme u nanosekundama, za merenje trajanja u histogramima
+unsigned long long getMetricsClock();
+
+// Broj vrednosti u histogramu i vrednost ispod koje je dati procenat vrednosti (gornja granica
+// korpe, pomnozena sa scale)
+long long getHistogramCount(int metric);
+double getHistogramPercentile(int metric, double percent);
+
+// Sve metrike u tekstualnom formatu Prometheus-a
+std::string formatMetrics();
+
+// Upisuje metrike u fajl (preko privremenog fajla, da citalac nikad ne vidi pola fajla)
+bool dumpMetrics(const char* path);
+
+// Pokrece nit koja odgovara na HTTP zahteve na 127.0.0.1:port; vraca false ako port nije dostupan
+bool startMetricsServer(int port);
+void stopMetricsServer();
@@ -0,0 +1,195 @@
+#include "Network.h"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Poslednja dodeljena revizija; zajednicka za sve mreze, pa dve razlicite mreze nemaju istu reviziju
+static std::atomic<unsigned int> lastNetworkRevision(0);
+
+void markNetworkChanged(Network& network) {
+    network.revision = ++lastNetworkRevision;
+}
+
+void makeLoopNetwork(Network& network, int numStops, float a, float b) {
+    network = Network();
+    network.numStops = numStops;
+    network.numRoutes = 1;
+    network.stopPositions.resize(numStops * 2);
+    network.routeOffsets.assign(2, 0);
+    network.routeOffsets[1] = numStops;
+    network.routeStops.resize(numStops);
+
+    for (int i = 0; i < numStops; ++i) {
+        float angle = i * 2 * M_PI / numStops;
+        network.stopPositions[2 * i] = cos(angle) * a;
+        network.stopPositions[2 * i + 1] = sin(angle) * b;
+        network.routeStops[i] = i;
+    }
+
+    buildNetworkSegments(network);
+}
+
+bool buildNetworkSegments(Network& network) {
+    const int numStops = network.numStops;
+    const int numRoutes = network.numRoutes;
+    const std::vector<int>& offsets = network.routeOffsets;
+    const std::vector<int>& stops = network.routeStops;
+
+    for (int r = 0; r < numRoutes; ++r) {
+        if (offsets[r + 1] - offsets[r] < 2) {
+            std::cerr << "Linija " << r << " ima manje od dve stanice." << std::endl;
+            return false;
+        }
+        for (int k = offsets[r]; k < offsets[r + 1]; ++k) {
+            if (stops[k] < 0 || stops[k] >= numStops) {
+                std::cerr << "Linija " << r << " ima nepostojecu stanicu " << stops[k] << "." << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // Sve veze (od, do) sa svih linija, grupisane po polaznoj stanici (counting sort)
+    std::vector<int>& segmentOffsets = network.segmentOffsets;
+    segmentOffsets.assign(numStops + 1, 0);
+    for (int r = 0; r < numRoutes; ++r) {
+        for (int k = offsets[r]; k < offsets[r + 1]; ++k)
+            segmentOffsets[stops[k] + 1]++;
+    }
+    for (int s = 0; s < numStops; ++s)
+        segmentOffsets[s + 1] += segmentOffsets[s];
+
+    std::vector<int> links(stops.size());
+    std::vector<int> fill(segmentOffsets.begin(), segmentOffsets.end() - 1);
+    for (int r = 0; r < numRoutes; ++r) {
+        for (int k = offsets[r]; k < offsets[r + 1]; ++k) {
+            int next = k + 1 == offsets[r + 1] ? offsets[r] : k + 1;
+            if (stops[next] == stops[k]) {
+                std::cerr << "Linija " << r << " ima istu stanicu dva puta zaredom (" << stops[k] << ")." << std::endl;
+                return false;
+            }
+            links[fill[stops[k]]++] = stops[next];
+        }
+    }
+
+    // Iste veze vise linija postaju jedan segment
+    std::vector<int>& segmentTo = network.segmentTo;
+    segmentTo.clear();
+    segmentTo.reserve(links.size());
+    int begin = 0;
+    for (int s = 0; s < numStops; ++s) {
+        int end = segmentOffsets[s + 1];
+        std::sort(links.begin() + begin, links.begin() + end);
+        segmentOffsets[s] = (int)segmentTo.size();
+        for (int k = begin; k < end; ++k) {
+            if (k == begin || links[k] != links[k - 1])
+                segmentTo.push_back(links[k]);
+        }
+        begin = end;
+    }
+    segmentOffsets[numStops] = (int)segmentTo.size();
+    segmentTo.shrink_to_fit();
+    network.numSegments = (int)segmentTo.size();
+
+    network.routeSegments.resize(stops.size());
+    for (int r = 0; r < numRoutes; ++r) {
+        for (int k = offsets[r]; k < offsets[r + 1]; ++k) {
+            int next = k + 1 == offsets[r + 1] ? offsets[r] : k + 1;
+            const int* first = segmentTo.data() + segmentOffsets[stops[k]];
+            const int* last = segmentTo.data() + segmentOffsets[stops[k] + 1];
+            network.routeSegments[k] = (int)(std::lower_bound(first, last, stops[next]) - segmentTo.data());
+        }
+    }
+    markNetworkChanged(network);
+    return true;
+}
+
+// Preskace komentare i cita sledecu rec iz fajla
+static bool readToken(std::ifstream& file, std::string& token) {
+    while (file >> token) {
+        if (token[0] != '#')
+            return true;
+        std::getline(file, token);
+    }
+    return false;
+}
+
+static bool readCount(std::ifstream& file, const char* keyword, int& count) {
+    std::string token;
+    if (!readToken(file, token) || token != keyword || !readToken(file, token))
+        return false;
+    count = atoi(token.c_str());
+    return count > 0;
+}
+
+bool loadNetwork(Network& network, const char* path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Greska pri citanju mreze sa putanje \"" << path << "\"!" << std::endl;
+        return false;
+    }
+
+    network = Network();
+    std::string token;
+    if (!readCount(file, "stops", network.numStops)) {
+        std::cerr << "Mreza \"" << path << "\": ocekivano \"stops <broj>\"." << std::endl;
+        return false;
+    }
+    network.stopPositions.resize((size_t)network.numStops * 2);
+    for (size_t i = 0; i < network.stopPositions.size(); ++i) {
+        if (!readToken(file, token)) {
+            std::cerr << "Mreza \"" << path << "\": nedostaju koordinate stanica." << std::endl;
+            return false;
+        }
+        network.stopPositions[i] = (float)atof(token.c_str());
+    }
+
+    if (!readCount(file, "routes", network.numRoutes)) {
+        std::cerr << "Mreza \"" << path << "\": ocekivano \"routes <broj>\"." << std::endl;
+        return false;
+    }
+    network.routeOffsets.assign(network.numRoutes + 1, 0);
+    for (int r = 0; r < network.numRoutes; ++r) {
+        int length = 0;
+        if (!readToken(file, token) || (length = atoi(token.c_str())) <= 0) {
+            std::cerr << "Mreza \"" << path << "\": nedostaje broj stanica linije " << r << "." << std::endl;
+            return false;
+        }
+        for (int k = 0; k < length; ++k) {
+            if (!readToken(file, token)) {
+                std::cerr << "Mreza \"" << path << "\": nedostaju stanice linije " << r << "." << std::endl;
+                return false;
+            }
+            network.routeStops.push_back(atoi(token.c_str()));
+        }
+        network.routeOffsets[r + 1] = (int)network.routeStops.size();
+    }
+
+    if (!buildNetworkSegments(network))
+        return false;
+    std::cout << "Uspesno procitana mreza sa putanje \"" << path << "\"!" << std::endl;
+    return true;
+}
+
+size_t getNetworkMemoryBytes(const Network& network) {
+    return network.stopPositions.capacity() * sizeof(float)
+        + network.routeOffsets.capacity() * sizeof(int)
+        + network.routeStops.capacity() * sizeof(int)
+        + network.routeSegments.capacity() * sizeof(int)
+        + network.segmentOffsets.capacity() * sizeof(int)
+        + network.segmentTo.capacity() * sizeof(int);
+}
+
+void printNetworkSummary(const Network& network) {
+    double megabytes = getNetworkMemoryBytes(network) / (1024.0 * 1024.0);
+    std::cout << "Mreza: " << network.numStops << " stanica, " << network.numRoutes << " linija, "
+        << network.numSegments << " segmenata, " << megabytes << " MB ("
+        << megabytes * 1e6 / network.numStops << " MB na milion stanica)" << std::endl;
+}
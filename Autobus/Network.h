@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// Mreza stanica i linija u CSR (compressed sparse row) obliku: umesto niza vektora, svaka
+// lista je deo jednog zajednickog niza, a niz pomeraja (offsets) kaze gde pocinje. Svi indeksi
+// su 32-bitni (int), pa mreza od milion stanica staje u nekoliko desetina MB.
+//
+// Linija je zatvoren niz stanica kojim autobus kruzi; segment je usmerena veza izmedju dve
+// stanice. Linije koje prolaze istim delom grada dele stanice i segmente (pa i njihovu putanju).
+
+struct Network {
+    int numStops = 0;
+    int numRoutes = 0;
+    int numSegments = 0;
+
+    // Koordinate stanica (x, y parovi)
+    std::vector<float> stopPositions;
+
+    // Stanice linije r: routeStops[routeOffsets[r] .. routeOffsets[r + 1] - 1], posle poslednje
+    // linija se vraca na prvu. routeSegments[k] je segment od routeStops[k] do sledece stanice.
+    std::vector<int> routeOffsets;
+    std::vector<int> routeStops;
+    std::vector<int> routeSegments;
+
+    // Segmenti koji izlaze iz stanice s: segmentOffsets[s] .. segmentOffsets[s + 1] - 1
+    // (sortirani po odredisnoj stanici, segmentTo)
+    std::vector<int> segmentOffsets;
+    std::vector<int> segmentTo;
+    // Revizija stanica: nova vrednost posle svake promene stopPositions (markNetworkChanged), da bi
+    // ono sto je napravljeno od stanica (npr. bafer za crtanje) znalo da li je zastarelo. Kopija
+    // mreze ima istu reviziju; 0 znaci da revizija nije dodeljena.
+    unsigned int revision = 0;
+};
+
+// Dodeljuje mrezi novu reviziju (jedinstvenu medju svim mrezama); poziva se posle promene stanica
+void markNetworkChanged(Network& network);
+
+// Jedna kruzna linija sa numStops stanica na elipsi sa poluosama a i b
+void makeLoopNetwork(Network& network, int numStops, float a, float b);
+
+// Pravi segmente (i routeSegments) iz stanica i linija; poziva se kad su stopPositions,
+// routeOffsets i routeStops popunjeni, i dodeljuje mrezi novu reviziju. Vraca false ako linija
+// nije ispravna.
+bool buildNetworkSegments(Network& network);
+
+// Ucitava mrezu iz tekstualnog fajla:
+//   stops <broj stanica>      pa za svaku stanicu: <x> <y>
+//   routes <broj linija>      pa za svaku liniju:  <broj stanica> <stanica> <stanica> ...
+// Linije koje pocinju sa # su komentari. Vraca false (i ispisuje gresku) ako fajl nije ispravan.
+bool loadNetwork(Network& network, const char* path);
+
+// Broj bajtova koje zauzimaju nizovi mreze
+size_t getNetworkMemoryBytes(const Network& network);
+
+// Ispisuje velicinu mreze i memoriju (ukupno i preracunato na milion stanica)
+void printNetworkSummary(const Network& network);
+
+// Sledeca stanica na liniji (redni broj u liniji, pocevsi od 0)
+inline int nextRouteStop(const Network& network, int route, int routeStop) {
+    int next = routeStop + 1;
+    return next == network.routeOffsets[route + 1] - network.routeOffsets[route] ? 0 : next;
+}
+
+// Prethodna stanica na liniji
+inline int previousRouteStop(const Network& network, int route, int routeStop) {
+    return routeStop == 0 ? network.routeOffsets[route + 1] - network.routeOffsets[route] - 1 : routeStop - 1;
+}
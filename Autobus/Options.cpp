@@ -0,0 +1,68 @@
+#include "Options.h"
+#include "Simulation.h"
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+bool hasArgument(int argc, char** argv, const char* name) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], name) == 0)
+            return true;
+    }
+    return false;
+}
+
+const char* getArgument(int argc, char** argv, const char* name, const char* defaultValue) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], name) == 0)
+            return argv[i + 1];
+    }
+    return defaultValue;
+}
+
+double getArgumentDouble(int argc, char** argv, const char* name, double defaultValue) {
+    const char* value = getArgument(argc, argv, name, nullptr);
+    return value != nullptr ? atof(value) : defaultValue;
+}
+
+long long getArgumentInt(int argc, char** argv, const char* name, long long defaultValue) {
+    const char* value = getArgument(argc, argv, name, nullptr);
+    return value != nullptr ? atoll(value) : defaultValue;
+}
+
+unsigned long long getSeedArgument(int argc, char** argv) {
+    const char* value = getArgument(argc, argv, "--seed", nullptr);
+    unsigned long long seed = value != nullptr ? strtoull(value, nullptr, 10) : (unsigned long long)time(NULL);
+    std::cout << "Seme simulacije: " << seed << " (ponavljanje: --seed " << seed << ")" << std::endl;
+    return seed;
+}
+
+bool getNetworkArgument(int argc, char** argv, Network& network) {
+    const char* path = getArgument(argc, argv, "--network", nullptr);
+    if (path == nullptr)
+        makeLoopNetwork(network, NUM_STATIONS, ROUTE_AXIS_A, ROUTE_AXIS_B);
+    else if (!loadNetwork(network, path))
+        return false;
+    printNetworkSummary(network);
+    return true;
+}
+
+bool getSimulationConfig(int argc, char** argv, SimulationConfig& config) {
+    config = SimulationConfig();
+    config.numBuses = (int)getArgumentInt(argc, argv, "--buses", config.numBuses);
+    config.passengerCapacity = (int)getArgumentInt(argc, argv, "--passengers", config.passengerCapacity);
+    config.demand = getArgumentDouble(argc, argv, "--demand", config.demand);
+    config.numInspectors = (int)getArgumentInt(argc, argv, "--inspectors", config.numInspectors);
+    config.transferPolicy = parseTransferPolicy(getArgument(argc, argv, "--inspector-policy", "next"));
+    if (config.numBuses <= 0 || config.passengerCapacity < 0 || config.demand < 0.0 || config.numInspectors < 0) {
+        std::cerr << "Neispravan broj autobusa, putnika ili kontrolora." << std::endl;
+        return false;
+    }
+    if (config.transferPolicy < 0) {
+        std::cerr << "Nepoznato pravilo presedanja kontrolora (next, loaded, random)." << std::endl;
+        return false;
+    }
+    config.seed = getSeedArgument(argc, argv);
+    return true;
+}
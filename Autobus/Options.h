@@ -0,0 +1,25 @@
+#pragma once
+#include "Network.h"
+
+struct SimulationConfig;
+
+// Pomocne funkcije za citanje argumenata komandne linije (--ime vrednost)
+
+// Da li je zastavica prisutna u argumentima
+bool hasArgument(int argc, char** argv, const char* name);
+
+// Vrednost iza zastavice, ili defaultValue ako zastavica nije navedena
+const char* getArgument(int argc, char** argv, const char* name, const char* defaultValue);
+double getArgumentDouble(int argc, char** argv, const char* name, double defaultValue);
+long long getArgumentInt(int argc, char** argv, const char* name, long long defaultValue);
+
+// Seme simulacije iz --seed, a ako nije zadato, iz trenutnog vremena (ispisuje se da bi se pokretanje moglo ponoviti)
+unsigned long long getSeedArgument(int argc, char** argv);
+
+// Mreza iz fajla zadatog sa --network, a ako nije zadat, podrazumevana kruzna linija
+// (vraca false ako fajl ne moze da se ucita)
+bool getNetworkArgument(int argc, char** argv, Network& network);
+
+// Velicine simulacije (--buses, --passengers, --demand, --inspectors, --inspector-policy) i seme;
+// vraca false (i ispisuje gresku) ako neka vrednost nije ispravna
+bool getSimulationConfig(int argc, char** argv, SimulationConfig& config);
@@ -0,0 +1,197 @@
+#include "Passengers.h"
+#include "Simulation.h"
+#include "Bits.h"
+#include <algorithm>
+
+// Reci karata po autobusu
+static const int TICKET_WORDS = (MAX_PASSENGERS + 63) / 64;
+
+static unsigned long long* getTicketWords(Passengers& passengers, int bus) {
+    return passengers.ticketBits.data() + (size_t)bus * TICKET_WORDS;
+}
+
+static void setTicketBit(unsigned long long* words, int seat, bool hasTicket) {
+    unsigned long long bit = 1ull << (seat & 63);
+    words[seat >> 6] = hasTicket ? words[seat >> 6] | bit : words[seat >> 6] & ~bit;
+}
+
+static bool getTicketBit(const unsigned long long* words, int seat) {
+    return (words[seat >> 6] >> (seat & 63)) & 1;
+}
+
+// Bitovi zauzetih mesta u reci word za autobus sa load putnika
+static unsigned long long getOccupiedMask(int load, int word) {
+    int count = load - 64 * word;
+    return count >= 64 ? ~0ull : count <= 0 ? 0ull : (1ull << count) - 1;
+}
+
+void initPassengers(Passengers& passengers, const Network& network, int numBuses, int capacity, double demand) {
+    passengers = Passengers();
+    passengers.capacity = capacity;
+    passengers.demand = demand;
+    passengers.origin.assign(capacity, 0);
+    passengers.destination.assign(capacity, 0);
+    passengers.hasTicket.assign(capacity, 0);
+    passengers.boardingTime.assign(capacity, -1.0f);
+    passengers.next.resize(capacity);
+
+    // Svi putnici su na pocetku slobodni; lista slobodnih ide redom da bi novi putnici bili blizu u memoriji
+    for (int i = 0; i < capacity; ++i)
+        passengers.next[i] = i + 1 < capacity ? i + 1 : -1;
+    passengers.freeList = capacity > 0 ? 0 : -1;
+
+    initStopQueues(passengers.queues, (int)network.routeStops.size(), capacity);
+    passengers.seats.assign((size_t)numBuses * MAX_PASSENGERS, -1);
+    passengers.ticketBits.assign((size_t)numBuses * TICKET_WORDS, 0);
+}
+
+static void releasePassenger(Passengers& passengers, int passenger) {
+    passengers.next[passenger] = passengers.freeList;
+    passengers.freeList = passenger;
+    passengers.count--;
+}
+
+int createPassenger(Passengers& passengers, const Network& network, int slot, RandomStream& stream) {
+    // Linija kojoj pripada mesto slot
+    int route = (int)(std::upper_bound(network.routeOffsets.begin(), network.routeOffsets.end(), slot) - network.routeOffsets.begin()) - 1;
+    int base = network.routeOffsets[route];
+    int length = network.routeOffsets[route + 1] - base;
+
+    // Putnik se vozi najmanje jednu, a najvise length - 1 stanicu
+    int ride = 1 + randomInt(stream, length - 1);
+    int destinationSlot = slot + ride < base + length ? slot + ride : slot + ride - length;
+    bool hasTicket = randomFloat(stream) < TICKET_PROBABILITY;
+
+    passengers.spawnedCount++;
+    int passenger = passengers.freeList;
+    if (passenger < 0) {
+        passengers.droppedCount++;
+        return -1;
+    }
+    passengers.freeList = passengers.next[passenger];
+    passengers.count++;
+
+    passengers.origin[passenger] = network.routeStops[slot];
+    passengers.destination[passenger] = network.routeStops[destinationSlot];
+    passengers.hasTicket[passenger] = hasTicket ? 1 : 0;
+    passengers.boardingTime[passenger] = -1.0f;
+    passengers.next[passenger] = -1;
+    return passenger;
+}
+
+void enqueuePassenger(Passengers& passengers, int slot, int passenger) {
+    pushQueue(passengers.queues, slot, passenger);
+}
+
+int spawnPassengers(Passengers& passengers, const Network& network, double deltaTime, unsigned long long seed) {
+    const int numSlots = (int)network.routeStops.size();
+    passengers.spawnAccumulator += passengers.demand * numSlots * deltaTime;
+    long long due = (long long)passengers.spawnAccumulator;
+    passengers.spawnAccumulator -= (double)due;
+
+    int created = 0;
+    for (long long i = 0; i < due; ++i) {
+        RandomStream stream = makeRandomStream(seed, STREAM_PASSENGER, (unsigned int)passengers.spawnedCount);
+        int slot = randomInt(stream, numSlots);
+        int passenger = createPassenger(passengers, network, slot, stream);
+        if (passenger < 0)
+            continue;
+        enqueuePassenger(passengers, slot, passenger);
+        created++;
+    }
+    return created;
+}
+
+bool seatPassenger(Passengers& passengers, Fleet& fleet, int bus, int passenger, float time) {
+    int& load = fleet.load[bus];
+    if (load >= MAX_PASSENGERS)
+        return false;
+    passengers.seats[(size_t)bus * MAX_PASSENGERS + load] = passenger;
+    setTicketBit(getTicketWords(passengers, bus), load, passengers.hasTicket[passenger] != 0);
+    passengers.boardingTime[passenger] = time;
+    passengers.boardedCount++;
+    load++;
+    return true;
+}
+
+void removeSeatedPassenger(Passengers& passengers, Fleet& fleet, int bus, int seat) {
+    int* seats = passengers.seats.data() + (size_t)bus * MAX_PASSENGERS;
+    unsigned long long* tickets = getTicketWords(passengers, bus);
+    int& load = fleet.load[bus];
+    releasePassenger(passengers, seats[seat]);
+    // Poslednji putnik (i njegova karta) prelazi na oslobodjeno mesto, da bi zauzeta mesta bila na pocetku
+    seats[seat] = seats[load - 1];
+    setTicketBit(tickets, seat, getTicketBit(tickets, load - 1));
+    seats[load - 1] = -1;
+    setTicketBit(tickets, load - 1, false);
+    load--;
+}
+
+int boardPassengers(Passengers& passengers, Fleet& fleet, int bus, int slot, float time) {
+    int& load = fleet.load[bus];
+    int* seats = passengers.seats.data() + (size_t)bus * MAX_PASSENGERS + load;
+    int boarded = popQueue(passengers.queues, slot, seats, MAX_PASSENGERS - load);
+    unsigned long long* tickets = getTicketWords(passengers, bus);
+    for (int i = 0; i < boarded; ++i) {
+        passengers.boardingTime[seats[i]] = time;
+        setTicketBit(tickets, load + i, passengers.hasTicket[seats[i]] != 0);
+    }
+    load += boarded;
+    passengers.boardedCount += boarded;
+    return boarded;
+}
+
+int alightPassengers(Passengers& passengers, Fleet& fleet, int bus, int station) {
+    const int* seats = passengers.seats.data() + (size_t)bus * MAX_PASSENGERS;
+    int alighted = 0;
+    for (int seat = 0; seat < fleet.load[bus];) {
+        if (passengers.destination[seats[seat]] == station) {
+            removeSeatedPassenger(passengers, fleet, bus, seat);
+            alighted++;
+        }
+        else {
+            seat++;
+        }
+    }
+    passengers.alightedCount += alighted;
+    return alighted;
+}
+
+int countFareEvaders(const Passengers& passengers, const Fleet& fleet, int bus) {
+    const unsigned long long* tickets = passengers.ticketBits.data() + (size_t)bus * TICKET_WORDS;
+    int load = fleet.load[bus];
+    int evaders = 0;
+    for (int word = 0; word < TICKET_WORDS; ++word)
+        evaders += countSetBits(getOccupiedMask(load, word) & ~tickets[word]);
+    return evaders;
+}
+
+int inspectBus(Passengers& passengers, Fleet& fleet, int bus) {
+    int* seats = passengers.seats.data() + (size_t)bus * MAX_PASSENGERS;
+    unsigned long long* tickets = getTicketWords(passengers, bus);
+    int load = fleet.load[bus];
+    if (countFareEvaders(passengers, fleet, bus) == 0)
+        return 0;
+
+    // Oslobadjamo putnike bez karte, a putnike sa kartom sabijamo na prva mesta (redom, bez menjanja
+    // redosleda); posle toga su karte prvih kept mesta sve jedinice
+    int fined = 0;
+    int kept = 0;
+    for (int word = 0; word < TICKET_WORDS; ++word) {
+        unsigned long long occupied = getOccupiedMask(load, word);
+        for (unsigned long long evaders = occupied & ~tickets[word]; evaders != 0; evaders &= evaders - 1) {
+            releasePassenger(passengers, seats[64 * word + countTrailingZeros(evaders)]);
+            fined++;
+        }
+        for (unsigned long long holders = occupied & tickets[word]; holders != 0; holders &= holders - 1)
+            seats[kept++] = seats[64 * word + countTrailingZeros(holders)];
+    }
+    for (int seat = kept; seat < load; ++seat)
+        seats[seat] = -1;
+    for (int word = 0; word < TICKET_WORDS; ++word)
+        tickets[word] = getOccupiedMask(kept, word);
+
+    fleet.load[bus] = kept;
+    passengers.finedCount += fined;
+    return fined;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+#include "Network.h"
+#include "Fleet.h"
+#include "Random.h"
+#include "StopQueues.h"
+
+// Putnici kao pojedinacni agenti. Svi podaci su u paralelnim nizovima (kolonama) unapred
+// zauzetim za capacity putnika; oslobodjeni putnici idu u listu slobodnih i ponovo se koriste,
+// pa simulacija u toku rada ne zauzima memoriju. Kad su sva mesta zauzeta, novi putnici se ne prave.
+//
+// Putnik se pojavljuje na stanici jedne linije, ceka u redu te linije na toj stanici, ulazi u
+// autobus te linije kad on krene sa stanice i izlazi na odredisnoj stanici.
+
+// Podrazumevana potraznja: putnika u sekundi po stanici linije (--demand)
+const double DEFAULT_PASSENGER_DEMAND = 0.05;
+// Podrazumevan najveci broj putnika u isto vreme (--passengers)
+const int DEFAULT_PASSENGER_CAPACITY = 100000;
+// Verovatnoca da putnik ima kartu
+const float TICKET_PROBABILITY = 0.9f;
+
+struct Passengers {
+    int capacity = 0;
+    int count = 0;                       // Broj putnika u sistemu (na stanicama i u autobusima)
+
+    // Kolone (indeks je oznaka putnika)
+    std::vector<int> origin;             // Stanica na kojoj se putnik pojavio
+    std::vector<int> destination;        // Stanica na kojoj izlazi
+    std::vector<unsigned char> hasTicket;
+    std::vector<float> boardingTime;     // Vreme ulaska u autobus (-1 dok ceka)
+    std::vector<int> next;               // Sledeci u listi slobodnih
+    int freeList = -1;
+
+    // Red cekanja linije na stanici; indeks reda je mesto u network.routeStops (linija + redni broj stanice)
+    StopQueues queues;
+
+    // Putnici u autobusima: seats[bus * MAX_PASSENGERS + k], k < fleet.load[bus]
+    std::vector<int> seats;
+
+    // Karte putnika u autobusima kao niz bitova: bit k je 1 ako putnik na mestu k ima kartu.
+    // Svaki autobus ima (MAX_PASSENGERS + 63) / 64 reci od 64 bita, jednu za drugom.
+    std::vector<unsigned long long> ticketBits;
+
+    // Potraznja (putnika u sekundi po stanici linije) i koliko putnika duguje tekuci korak
+    double demand = DEFAULT_PASSENGER_DEMAND;
+    double spawnAccumulator = 0.0;
+
+    // Statistika
+    long long spawnedCount = 0;
+    long long droppedCount = 0;          // Nisu napravljeni jer su sva mesta bila zauzeta
+    long long boardedCount = 0;
+    long long alightedCount = 0;
+    long long finedCount = 0;            // Izbaceni u kontroli jer nisu imali kartu
+};
+
+// Zauzima sve nizove unapred: capacity putnika i mesta za numBuses autobusa
+void initPassengers(Passengers& passengers, const Network& network, int numBuses, int capacity, double demand);
+
+// Pravi putnike koji su se pojavili za deltaTime sekundi; svaki putnik ima svoj tok slucajnih
+// brojeva, pa ishod ne zavisi od duzine koraka. Vraca broj napravljenih putnika.
+int spawnPassengers(Passengers& passengers, const Network& network, double deltaTime, unsigned long long seed);
+
+// Novi putnik na mestu slot linije; odrediste na toj liniji i karta se biraju iz toka putnika
+// (makeRandomStream(seed, STREAM_PASSENGER, spawnedCount)). Vraca oznaku putnika ili -1 ako
+// nema mesta; putnik jos nije ni u redu ni u autobusu.
+int createPassenger(Passengers& passengers, const Network& network, int slot, RandomStream& stream);
+
+// Putnik staje na kraj reda mesta slot
+void enqueuePassenger(Passengers& passengers, int slot, int passenger);
+
+// Putnici iz reda mesta slot ulaze u autobus dok ima mesta (odjednom, kopiranjem iz reda na
+// slobodna mesta), vraca broj putnika koji su usli
+int boardPassengers(Passengers& passengers, Fleet& fleet, int bus, int slot, float time);
+
+// Putnici kojima je stanica odrediste izlaze iz autobusa, vraca broj putnika koji su izasli
+int alightPassengers(Passengers& passengers, Fleet& fleet, int bus, int station);
+
+// Smesta putnika u autobus (ako ima mesta)
+bool seatPassenger(Passengers& passengers, Fleet& fleet, int bus, int passenger, float time);
+
+// Izbacuje putnika sa mesta seat u autobusu i oslobadja ga
+void removeSeatedPassenger(Passengers& passengers, Fleet& fleet, int bus, int seat);
+
+// Broj putnika bez karte u autobusu (popcount nad recima karata, bez citanja samih putnika)
+int countFareEvaders(const Passengers& passengers, const Fleet& fleet, int bus);
+
+// Kontrola: izbacuje tacno putnike bez karte, vraca njihov broj. Posao je srazmeran broju reci
+// karata i broju kaznjenih, a ne broju putnika u autobusu.
+int inspectBus(Passengers& passengers, Fleet& fleet, int bus);
@@ -0,0 +1,172 @@
+#include "Profiler.h"
+
+#ifdef AUTOBUS_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+struct ProfileEvent {
+    const char* name;
+    unsigned long long start;   // Nanosekunde od pokretanja programa
+    unsigned long long end;
+    int frame;
+};
+
+// Kruzni bafer jedne niti. Pise samo vlasnik; dumpProfile cita iz druge niti, pa posle kopiranja
+// ponovo cita head i odbacuje zapise koje je pisac u medjuvremenu mogao da prepise.
+struct ProfileRing {
+    std::atomic<unsigned long long> head;
+    std::atomic<const char*> threadName;
+    int threadIndex;
+    ProfileEvent events[PROFILE_RING_EVENTS];
+};
+
+static const std::chrono::steady_clock::time_point profileEpoch = std::chrono::steady_clock::now();
+static std::atomic<int> profileFrame(0);
+static std::atomic<ProfileRing*> profileRings[PROFILE_MAX_THREADS];
+static std::atomic<int> profileRingCount(0);
+static thread_local ProfileRing* threadRing = nullptr;
+static thread_local bool threadRegistered = false;
+static ProfileRing* gpuRing = nullptr;
+
+static unsigned long long profileClock() {
+    return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - profileEpoch).count();
+}
+
+// Novi bafer (zauvek, da bi se video i posle zavrsetka niti); nullptr ako ih ima PROFILE_MAX_THREADS
+static ProfileRing* createRing(const char* threadName) {
+    int index = profileRingCount.fetch_add(1);
+    if (index >= PROFILE_MAX_THREADS)
+        return nullptr;
+    ProfileRing* ring = new ProfileRing();
+    ring->head = 0;
+    ring->threadName = threadName;
+    ring->threadIndex = index;
+    profileRings[index].store(ring, std::memory_order_release);
+    return ring;
+}
+
+// Prvo merenje niti: nit dobija svoj bafer
+static ProfileRing* getThreadRing() {
+    if (threadRegistered)
+        return threadRing;
+    threadRegistered = true;
+    threadRing = createRing(nullptr);
+    return threadRing;
+}
+
+static void pushEvent(ProfileRing* ring, const char* name, unsigned long long start, unsigned long long end, int frame) {
+    unsigned long long head = ring->head.load(std::memory_order_relaxed);
+    ProfileEvent& event = ring->events[head & (PROFILE_RING_EVENTS - 1)];
+    event.name = name;
+    event.start = start;
+    event.end = end;
+    event.frame = frame;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+ProfileScope::ProfileScope(const char* name) : name(name), start(profileClock()) {
+}
+
+ProfileScope::~ProfileScope() {
+    unsigned long long end = profileClock();
+    ProfileRing* ring = getThreadRing();
+    if (ring != nullptr)
+        pushEvent(ring, name, start, end, profileFrame.load(std::memory_order_relaxed));
+}
+
+unsigned long long getProfileClock() {
+    return profileClock();
+}
+
+int getProfileFrame() {
+    return profileFrame.load(std::memory_order_relaxed);
+}
+
+void recordProfileGpuEvent(const char* name, unsigned long long start, unsigned long long duration, int frame) {
+    if (gpuRing == nullptr)
+        gpuRing = createRing("GPU");
+    if (gpuRing != nullptr)
+        pushEvent(gpuRing, name, start, start + duration, frame);
+}
+
+void markProfileFrame() {
+    profileFrame.fetch_add(1, std::memory_order_relaxed);
+}
+
+void setProfileThreadName(const char* name) {
+    ProfileRing* ring = getThreadRing();
+    if (ring != nullptr)
+        ring->threadName.store(name, std::memory_order_release);
+}
+
+// Ime u JSON niski (imena funkcija i literali, ali navodnici i \ se ipak izbegavaju)
+static void writeJsonName(FILE* file, const char* name) {
+    fputc('"', file);
+    for (const char* c = name; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\')
+            fputc('\\', file);
+        if ((unsigned char)*c >= 0x20)
+            fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+bool dumpProfile(const char* path, int frames) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        std::cerr << "Greska pri otvaranju fajla profila \"" << path << "\"!" << std::endl;
+        return false;
+    }
+    int firstFrame = profileFrame.load(std::memory_order_relaxed) - frames + 1;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    std::vector<ProfileEvent> events;
+    int count = profileRingCount.load(std::memory_order_acquire);
+    count = count < PROFILE_MAX_THREADS ? count : PROFILE_MAX_THREADS;
+    for (int i = 0; i < count; ++i) {
+        ProfileRing* ring = profileRings[i].load(std::memory_order_acquire);
+        if (ring == nullptr)
+            continue;
+
+        unsigned long long head = ring->head.load(std::memory_order_acquire);
+        unsigned long long from = head > (unsigned long long)PROFILE_RING_EVENTS ? head - PROFILE_RING_EVENTS : 0;
+        events.clear();
+        for (unsigned long long j = from; j < head; ++j)
+            events.push_back(ring->events[j & (PROFILE_RING_EVENTS - 1)]);
+        unsigned long long headAfter = ring->head.load(std::memory_order_acquire);
+        unsigned long long valid = headAfter > (unsigned long long)PROFILE_RING_EVENTS ? headAfter - PROFILE_RING_EVENTS : 0;
+        size_t skip = valid > from ? (size_t)(valid - from) : 0;
+
+        const char* threadName = ring->threadName.load(std::memory_order_acquire);
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+            first ? "" : ",", ring->threadIndex);
+        if (threadName != nullptr)
+            writeJsonName(file, threadName);
+        else
+            fprintf(file, "\"nit %d\"", ring->threadIndex);
+        fprintf(file, "}}");
+        first = false;
+
+        for (size_t j = skip; j < events.size(); ++j) {
+            const ProfileEvent& event = events[j];
+            if (event.frame < firstFrame)
+                continue;
+            fprintf(file, ",\n{\"name\":");
+            writeJsonName(file, event.name);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%d}}",
+                ring->threadIndex, event.start / 1000.0, (event.end - event.start) / 1000.0, event.frame);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+
+// Profajler delova frejma: PROFILE_SCOPE("ime") meri trajanje bloka u kome je napisan (od mesta
+// gde stoji do kraja bloka), PROFILE_FUNCTION() trajanje cele funkcije. Svaka nit upisuje merenja u
+// svoj kruzni bafer od PROFILE_RING_EVENTS zapisa (bez zakljucavanja i zauzimanja memorije), a
+// dumpProfile ispisuje poslednjih N frejmova u formatu Chrome trace (JSON), koji otvaraju
+// chrome://tracing i ui.perfetto.dev.
+//
+// Profajler postoji samo ako je definisan AUTOBUS_PROFILE (u projektu: Debug konfiguracije); bez
+// njega se svi makroi svode na prazne naredbe, pa merenje ne kosta nista.
+
+// Najvise niti koje mere i zapisa po niti (stariji zapisi se prepisuju)
+const int PROFILE_MAX_THREADS = 16;
+const int PROFILE_RING_EVENTS = 1 << 16;
+
+// Podrazumevani broj poslednjih frejmova u ispisu
+const int PROFILE_DEFAULT_FRAMES = 300;
+
+#ifdef AUTOBUS_PROFILE
+
+// Meri od konstrukcije do destrukcije (kraja bloka)
+struct ProfileScope {
+    const char* name;
+    unsigned long long start;
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+};
+
+// Pocetak novog frejma: zapisi se grupisu po frejmu u kome su poceli
+void markProfileFrame();
+
+// Ime niti u ispisu (podrazumevano "nit <broj>")
+void setProfileThreadName(const char* name);
+
+// Vreme profajlera (nanosekunde od pokretanja) i redni broj tekuceg frejma
+unsigned long long getProfileClock();
+int getProfileFrame();
+
+// Zapis u posebnu traku "GPU": trajanje dela crtanja na GPU-u (GpuTimer.h), postavljeno na trenutak
+// kada je deo poslat i na frejm u kome je poslat. Poziva se samo iz niti koja crta.
+void recordProfileGpuEvent(const char* name, unsigned long long start, unsigned long long duration, int frame);
+
+// Upisuje zapise poslednjih frames frejmova svih niti; vraca false ako fajl ne moze da se otvori
+bool dumpProfile(const char* path, int frames);
+
+#define PROFILE_JOIN_NAME(a, b) a##b
+#define PROFILE_SCOPE_NAME(line) PROFILE_JOIN_NAME(profileScope, line)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_SCOPE_NAME(__LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_FRAME() markProfileFrame()
+#define PROFILE_THREAD(name) setProfileThreadName(name)
+#define PROFILE_DUMP(path, frames) dumpProfile(path, frames)
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#define PROFILE_DUMP(path, frames) ((void)0)
+
+#endif
@@ -0,0 +1,65 @@
+#include "Random.h"
+
+// Konstante iz rada "Parallel Random Numbers: As Easy as 1, 2, 3" (Salmon et al.)
+const unsigned int PHILOX_M0 = 0xD2511F53u;
+const unsigned int PHILOX_M1 = 0xCD9E8D57u;
+const unsigned int PHILOX_W0 = 0x9E3779B9u;
+const unsigned int PHILOX_W1 = 0xBB67AE85u;
+const int PHILOX_ROUNDS = 10;
+
+void philox4x32(const unsigned int key[2], const unsigned int counter[4], unsigned int out[4]) {
+    unsigned int c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    unsigned int k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+        unsigned long long p0 = (unsigned long long)PHILOX_M0 * c0;
+        unsigned long long p1 = (unsigned long long)PHILOX_M1 * c2;
+        unsigned int hi0 = (unsigned int)(p0 >> 32), lo0 = (unsigned int)p0;
+        unsigned int hi1 = (unsigned int)(p1 >> 32), lo1 = (unsigned int)p1;
+
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+RandomStream makeRandomStream(unsigned long long seed, int kind, unsigned int id) {
+    RandomStream stream;
+    stream.key[0] = (unsigned int)seed;
+    stream.key[1] = (unsigned int)(seed >> 32);
+    stream.streamId[0] = (unsigned int)kind;
+    stream.streamId[1] = id;
+    stream.counter = 0;
+    return stream;
+}
+
+unsigned int randomUint(RandomStream& stream) {
+    // Jedan Philox blok daje 4 broja; brojac bira blok i rec u njemu
+    unsigned long long block = stream.counter >> 2;
+    unsigned int counter[4] = { (unsigned int)block, (unsigned int)(block >> 32), stream.streamId[0], stream.streamId[1] };
+    unsigned int out[4];
+    philox4x32(stream.key, counter, out);
+    return out[stream.counter++ & 3];
+}
+
+float randomFloat(RandomStream& stream) {
+    // Gornja 24 bita staju tacno u mantisu float-a
+    return (randomUint(stream) >> 8) * (1.0f / 16777216.0f);
+}
+
+int randomInt(RandomStream& stream, int n) {
+    return (int)(((unsigned long long)randomUint(stream) * (unsigned int)n) >> 32);
+}
+
+float randomOffset(RandomStream& stream, float range) {
+    // Generisanje broja izmedju 0 i 1, pa skaliranje i pomeranje
+    return (randomFloat(stream) * 2.0f - 1.0f) * range;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// Deterministicki generator slucajnih brojeva zasnovan na brojacu (Philox4x32-10).
+// Broj je cista funkcija (seme, tok, redni broj), bez zajednickog globalnog stanja kao kod rand(),
+// pa svaki autobus, segment putanje i kontrolor imaju svoj nezavisan tok. Rezultat ne zavisi od
+// redosleda izvrsavanja ni od broja niti, a cela simulacija se ponavlja zadavanjem istog semena.
+
+enum RandomStreamKind {
+    STREAM_BUS = 1,        // Jedan tok po autobusu
+    STREAM_SEGMENT = 2,    // Jedan tok po segmentu putanje (krivudanje puta)
+    STREAM_INSPECTION = 3, // Jedan tok po kontroloru (pocetna stanica, presedanje)
+    STREAM_PASSENGER = 4   // Jedan tok po putniku (mesto pojavljivanja, odrediste, karta)
+};
+
+struct RandomStream {
+    unsigned int key[2];       // Iz semena
+    unsigned int streamId[2];  // Vrsta toka i redni broj (autobusa, segmenta, kontrolora...)
+    unsigned long long counter = 0;
+};
+
+// Blok od 4 slucajna 32-bitna broja za dati kljuc i brojac (Philox4x32, 10 rundi)
+void philox4x32(const unsigned int key[2], const unsigned int counter[4], unsigned int out[4]);
+
+// Tok odredjen semenom, vrstom toka i rednim brojem
+RandomStream makeRandomStream(unsigned long long seed, int kind, unsigned int id);
+
+// Sledeci broj iz toka
+unsigned int randomUint(RandomStream& stream);
+float randomFloat(RandomStream& stream);                // [0, 1)
+int randomInt(RandomStream& stream, int n);              // [0, n)
+float randomOffset(RandomStream& stream, float range);  // [-range, range)
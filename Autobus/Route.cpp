@@ -0,0 +1,107 @@
+#include "Route.h"
+#include "Random.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void buildRoutePath(RoutePath& route, const Network& network, int pointsPerSegment, float wiggleRange,
+    unsigned long long seed) {
+    const int numSegments = network.numSegments;
+    const float* stopPositions = network.stopPositions.data();
+    route.numSegments = numSegments;
+    route.points.clear();
+    route.points.reserve((size_t)numSegments * (pointsPerSegment + 1) * 2);
+    route.segmentOffsets.assign(numSegments + 1, 0);
+    route.cumulativeLength.clear();
+    route.segmentLength.assign(numSegments, 0.0f);
+
+    // Prolazimo kroz sve segmente (od stanice from do stanice to); segmenti su grupisani po polaznoj stanici
+    int from = 0;
+    for (int i = 0; i < numSegments; ++i) {
+        while (network.segmentOffsets[from + 1] <= i)
+            from++;
+        route.segmentOffsets[i] = (int)(route.points.size() / 2);
+
+        float x1 = stopPositions[2 * from];
+        float y1 = stopPositions[2 * from + 1];
+
+        int to = network.segmentTo[i];
+        float x2 = stopPositions[2 * to];
+        float y2 = stopPositions[2 * to + 1];
+
+        route.points.push_back(x1);
+        route.points.push_back(y1);
+
+        // Svaki segment ima svoj tok slucajnih brojeva, pa putanja zavisi samo od semena
+        RandomStream segmentStream = makeRandomStream(seed, STREAM_SEGMENT, (unsigned int)i);
+
+        // Dodavanje krivudavih tacaka izmedju dve stanice
+        for (int j = 1; j < pointsPerSegment; ++j) {
+
+            // Faktor interpolacije (t ide od 0 do 1)
+            float t = (float)j / pointsPerSegment;
+
+            // Linearna interpolacija (tacka na ravnoj liniji)
+            float interX = x1 * (1.0f - t) + x2 * t;
+            float interY = y1 * (1.0f - t) + y2 * t;
+
+            // Dodavanje nasumicnog pomeraja (WIGGLE)
+            float wiggleFactor = sin(t * M_PI);
+            float wiggleX = randomOffset(segmentStream, wiggleRange * wiggleFactor);
+            float wiggleY = randomOffset(segmentStream, wiggleRange * wiggleFactor);
+
+            route.points.push_back(interX + wiggleX);
+            route.points.push_back(interY + wiggleY);
+        }
+
+        // Segment se zavrsava sledecom stanicom, da bi autobus mogao da stigne do nje
+        route.points.push_back(x2);
+        route.points.push_back(y2);
+    }
+    route.segmentOffsets[numSegments] = (int)(route.points.size() / 2);
+
+    // Tabela duzine luka: put od pocetka segmenta do svake tacke
+    route.cumulativeLength.resize(route.points.size() / 2);
+    for (int i = 0; i < numSegments; ++i) {
+        int begin = route.segmentOffsets[i];
+        int end = route.segmentOffsets[i + 1];
+        float length = 0.0f;
+        route.cumulativeLength[begin] = 0.0f;
+        for (int p = begin + 1; p < end; ++p) {
+            float dx = route.points[2 * p] - route.points[2 * (p - 1)];
+            float dy = route.points[2 * p + 1] - route.points[2 * (p - 1) + 1];
+            length += sqrt(dx * dx + dy * dy);
+            route.cumulativeLength[p] = length;
+        }
+        route.segmentLength[i] = length;
+    }
+}
+
+void advanceRouteCursor(const RoutePath& route, int segment, float t, int& cursor, float& edgeT) {
+    int begin = route.segmentOffsets[segment];
+    int lastEdge = route.segmentOffsets[segment + 1] - 2;
+    const float* cumulative = route.cumulativeLength.data();
+    float distance = t * route.segmentLength[segment];
+
+    // Novi segment (ili vracanje unazad): krecemo od prve ivice segmenta
+    if (cursor < begin || cursor > lastEdge || cumulative[cursor] > distance)
+        cursor = begin;
+
+    while (cursor < lastEdge && cumulative[cursor + 1] < distance)
+        cursor++;
+
+    float edgeLength = cumulative[cursor + 1] - cumulative[cursor];
+    edgeT = edgeLength > 0.0f ? (distance - cumulative[cursor]) / edgeLength : 1.0f;
+    edgeT = edgeT > 1.0f ? 1.0f : edgeT;
+}
+
+void advanceRouteCursors(const RoutePath& route, const int* segment, const float* segmentTime, float invDuration,
+    int* cursor, float* edgeT, int n) {
+    for (int i = 0; i < n; ++i) {
+        float t = segmentTime[i] * invDuration;
+        t = t > 1.0f ? 1.0f : t;
+        advanceRouteCursor(route, segment[i], t, cursor[i], edgeT[i]);
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include "Network.h"
+
+// Putanja autobusa kao izlomljena linija: na svakom segmentu mreze (izmedju dve stanice) nalazi se
+// CURVE_POINTS_PER_SEGMENT krivudavih tacaka. Za pracenje putanje konstantnom brzinom svaka tacka
+// pamti predjeni put od pocetka svog segmenta (tabela duzine luka).
+
+const int CURVE_POINTS_PER_SEGMENT = 5; // broj tacaka izmedju dve stanice
+const float WIGGLE_RANGE = 0.08f;
+
+struct RoutePath {
+    // Tacke svih segmenata redom (x, y parovi); segment i zauzima tacke
+    // segmentOffsets[i] .. segmentOffsets[i + 1] - 1, ukljucujuci obe stanice
+    std::vector<float> points;
+    std::vector<int> segmentOffsets;
+    std::vector<float> cumulativeLength; // Put od pocetka segmenta do svake tacke
+    std::vector<float> segmentLength;
+    int numSegments = 0;
+};
+
+// Pravi putanju za svaki segment mreze (indeksi segmenata su isti kao u mrezi); krivudanje
+// svakog segmenta zavisi samo od semena
+void buildRoutePath(RoutePath& route, const Network& network, int pointsPerSegment, float wiggleRange,
+    unsigned long long seed);
+
+// Za autobus na segmentu segment koji je presao deo t (0..1) njegove duzine nalazi ivicu
+// izlomljene linije (cursor = indeks njene prve tacke) i polozaj na njoj (edgeT). Kursor se cuva
+// izmedju poziva: autobus se krece samo napred, pa se kursor u proseku pomera za O(1) ivica,
+// bez binarne pretrage.
+void advanceRouteCursor(const RoutePath& route, int segment, float t, int& cursor, float& edgeT);
+
+// advanceRouteCursor za n autobusa odjednom; t autobusa i je min(segmentTime[i] * invDuration, 1)
+void advanceRouteCursors(const RoutePath& route, const int* segment, const float* segmentTime, float invDuration,
+    int* cursor, float* edgeT, int n);
@@ -0,0 +1,143 @@
+#include "ShaderProgram.h"
+#include "GlState.h"
+#include "Util.h"
+#include <cstring>
+#include <iostream>
+
+// Ime iz glGetActive* (za niz "ime[0]") bez oznake niza
+static std::string baseName(const char* name) {
+    const char* bracket = strchr(name, '[');
+    return bracket != nullptr ? std::string(name, bracket - name) : std::string(name);
+}
+
+bool createShaderProgram(ShaderProgram& program, const char* vsSource, const char* fsSource) {
+    program = ShaderProgram();
+    program.id = createShader(vsSource, fsSource);
+
+    int linked = GL_FALSE;
+    glGetProgramiv(program.id, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE) {
+        std::cerr << "Sejder program (" << vsSource << ", " << fsSource << ") nije uspeo da se poveze!" << std::endl;
+        glDeleteProgram(program.id);
+        program.id = 0;
+        return false;
+    }
+
+    int count = 0, maxLength = 0;
+    glGetProgramiv(program.id, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program.id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> name(maxLength + 1);
+    for (int i = 0; i < count; ++i) {
+        ShaderUniform uniform;
+        GLenum type;
+        glGetActiveUniform(program.id, i, (GLsizei)name.size(), nullptr, &uniform.size, &type, name.data());
+        uniform.type = type;
+        uniform.location = glGetUniformLocation(program.id, name.data());
+        uniform.name = baseName(name.data());
+        // Uniforme iz blokova nemaju lokaciju i ne zadaju se pojedinacno
+        if (uniform.location >= 0)
+            program.uniforms.push_back(uniform);
+    }
+
+    glGetProgramiv(program.id, GL_ACTIVE_ATTRIBUTES, &count);
+    glGetProgramiv(program.id, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+    name.assign(maxLength + 1, '\0');
+    for (int i = 0; i < count; ++i) {
+        ShaderAttribute attribute;
+        GLenum type;
+        glGetActiveAttrib(program.id, i, (GLsizei)name.size(), nullptr, &attribute.size, &type, name.data());
+        attribute.type = type;
+        attribute.location = glGetAttribLocation(program.id, name.data());
+        attribute.name = baseName(name.data());
+        program.attributes.push_back(attribute);
+    }
+    return true;
+}
+
+void destroyShaderProgram(ShaderProgram& program) {
+    if (program.id != 0)
+        glDeleteProgram(program.id);
+    program = ShaderProgram();
+}
+
+int findUniform(const ShaderProgram& program, const char* name) {
+    for (size_t i = 0; i < program.uniforms.size(); ++i) {
+        if (program.uniforms[i].name == name)
+            return (int)i;
+    }
+    return -1;
+}
+
+int findAttribute(const ShaderProgram& program, const char* name) {
+    for (size_t i = 0; i < program.attributes.size(); ++i) {
+        if (program.attributes[i].name == name)
+            return (int)i;
+    }
+    return -1;
+}
+
+void useShaderProgram(const ShaderProgram& program) {
+    useProgram(program.id);
+}
+
+// Da li uniforma vec ima ove vrednosti; ako nema, pamti ih (poziv posle ovoga ih salje)
+static bool isUnchanged(ShaderProgram& program, ShaderUniform& uniform, const float* values, int count) {
+    if (uniform.cached && memcmp(uniform.values, values, count * sizeof(float)) == 0) {
+        program.skippedUploads++;
+        return true;
+    }
+    memcpy(uniform.values, values, count * sizeof(float));
+    uniform.cached = true;
+    program.uploads++;
+    return false;
+}
+
+void setUniform1f(ShaderProgram& program, int uniform, float x) {
+    if (uniform < 0)
+        return;
+    ShaderUniform& target = program.uniforms[uniform];
+    float values[1] = { x };
+    if (!isUnchanged(program, target, values, 1))
+        glUniform1f(target.location, x);
+}
+
+void setUniform2f(ShaderProgram& program, int uniform, float x, float y) {
+    if (uniform < 0)
+        return;
+    ShaderUniform& target = program.uniforms[uniform];
+    float values[2] = { x, y };
+    if (!isUnchanged(program, target, values, 2))
+        glUniform2f(target.location, x, y);
+}
+
+void setUniform4f(ShaderProgram& program, int uniform, float x, float y, float z, float w) {
+    if (uniform < 0)
+        return;
+    ShaderUniform& target = program.uniforms[uniform];
+    float values[4] = { x, y, z, w };
+    if (!isUnchanged(program, target, values, 4))
+        glUniform4f(target.location, x, y, z, w);
+}
+
+void setUniform1i(ShaderProgram& program, int uniform, int value) {
+    if (uniform < 0)
+        return;
+    ShaderUniform& target = program.uniforms[uniform];
+    if (target.cached && target.intValue == value) {
+        program.skippedUploads++;
+        return;
+    }
+    target.intValue = value;
+    target.cached = true;
+    program.uploads++;
+    glUniform1i(target.location, value);
+}
+
+void setUniform4fv(ShaderProgram& program, int uniform, const float* values, int count) {
+    if (uniform < 0)
+        return;
+    ShaderUniform& target = program.uniforms[uniform];
+    target.cached = false;
+    program.uploads++;
+    glUniform4fv(target.location, count < target.size ? count : target.size, values);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Sejder program sa tabelom aktivnih uniformi i atributa, procitanom jednom posle linkovanja.
+// Uniforma se u crtanju zadaje brojem u tabeli (findUniform pri pokretanju), pa u frejmu nema
+// trazenja po imenu (glGetUniformLocation). Tabela pamti poslednju poslatu vrednost, pa se
+// vrednost koja se nije promenila ne salje ponovo.
+
+struct ShaderUniform {
+    std::string name;      // Bez "[0]" za nizove
+    int location = -1;
+    unsigned int type = 0; // GL_FLOAT, GL_FLOAT_VEC2, GL_SAMPLER_2D...
+    int size = 0;          // Broj elemenata niza (1 za obicnu uniformu)
+    bool cached = false;   // Da li values sadrzi poslednju poslatu vrednost
+    float values[4] = {};
+    int intValue = 0;
+};
+
+struct ShaderAttribute {
+    std::string name;
+    int location = -1;
+    unsigned int type = 0;
+    int size = 0;
+};
+
+struct ShaderProgram {
+    unsigned int id = 0;
+    std::vector<ShaderUniform> uniforms;
+    std::vector<ShaderAttribute> attributes;
+    long long uploads = 0;          // Poslatih vrednosti
+    long long skippedUploads = 0;   // Preskocenih, jer je vrednost ista kao poslednja poslata
+};
+
+// Pravi program od fajlova sejdera (createShader) i cita njegove uniforme i atribute; vraca false
+// ako linkovanje nije uspelo
+bool createShaderProgram(ShaderProgram& program, const char* vsSource, const char* fsSource);
+void destroyShaderProgram(ShaderProgram& program);
+
+// Broj uniforme/atributa u tabeli, -1 ako ga program nema (npr. kompajler ga je izbacio jer se
+// ne koristi); setteri za -1 ne rade nista
+int findUniform(const ShaderProgram& program, const char* name);
+int findAttribute(const ShaderProgram& program, const char* name);
+
+void useShaderProgram(const ShaderProgram& program);
+
+// Setteri salju vrednost samo ako se razlikuje od poslednje poslate; kao i glUniform*, program
+// mora biti aktivan (useShaderProgram)
+void setUniform1f(ShaderProgram& program, int uniform, float x);
+void setUniform2f(ShaderProgram& program, int uniform, float x, float y);
+void setUniform4f(ShaderProgram& program, int uniform, float x, float y, float z, float w);
+void setUniform1i(ShaderProgram& program, int uniform, int value);
+
+// Niz od count vec4 vrednosti; salje se uvek (niz se ne pamti), pa je za uniforme koje se zadaju retko
+void setUniform4fv(ShaderProgram& program, int uniform, const float* values, int count);
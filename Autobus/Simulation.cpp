@@ -0,0 +1,173 @@
+#include "Simulation.h"
+#include "Random.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Profiler.h"
+
+// Metrike simulacije (vidi Metrics.h); ulasci i izlasci po zaustavljanju pokazuju koliko se
+// autobus zadrzava na stanici
+static const int TICK_SECONDS_METRIC = registerMetric(METRIC_HISTOGRAM, "autobus_tick_seconds", nullptr,
+    "Trajanje koraka simulacije", 1e-9);
+static const int TICKS_METRIC = registerMetric(METRIC_GAUGE, "autobus_ticks", nullptr, "Broj koraka simulacije");
+static const int STOP_BOARDINGS_METRIC = registerMetric(METRIC_HISTOGRAM, "autobus_stop_boardings", nullptr,
+    "Putnika koji su usli pri jednom polasku sa stanice");
+static const int STOP_ALIGHTINGS_METRIC = registerMetric(METRIC_HISTOGRAM, "autobus_stop_alightings", nullptr,
+    "Putnika koji su izasli pri jednom dolasku na stanicu");
+static const int FINED_METRIC = registerMetric(METRIC_COUNTER, "autobus_fined_total", nullptr, "Kaznjenih putnika");
+static const int PASSENGERS_METRIC = registerMetric(METRIC_GAUGE, "autobus_passengers", nullptr, "Putnika u sistemu");
+static const int SIMULATED_TIME_METRIC = registerMetric(METRIC_GAUGE, "autobus_simulated_seconds", nullptr,
+    "Simulirano vreme");
+
+// Trajanje se meri u svakom TICK_METRICS_INTERVAL-om koraku: citanje sata traje duze od koraka
+// sa malo autobusa
+const long long TICK_METRICS_INTERVAL = 64;
+
+void initSimulation(Simulation& sim, const Network& network, const SimulationConfig& config) {
+    sim = Simulation();
+    sim.network = network;
+    sim.seed = config.seed;
+
+    buildRoutePath(sim.route, sim.network, CURVE_POINTS_PER_SEGMENT, WIGGLE_RANGE, config.seed);
+
+    // Postavljamo autobuse na stanice na putanji
+    initFleet(sim.fleet, config.numBuses, sim.network, config.seed);
+    updateFleetPositions(sim.fleet, sim.route);
+
+    initPassengers(sim.passengers, sim.network, config.numBuses, config.passengerCapacity, config.demand);
+    initInspectors(sim.inspectors, config.numInspectors, config.transferPolicy, config.numBuses,
+        sim.network.numStops, config.seed);
+}
+
+void stepSimulation(Simulation& sim, float deltaTime) {
+    PROFILE_FUNCTION();
+    bool timed = sim.tickCount % TICK_METRICS_INTERVAL == 0;
+    unsigned long long start = timed ? getMetricsClock() : 0;
+    sim.time += deltaTime;
+    sim.tickCount++;
+
+    Fleet& fleet = sim.fleet;
+    spawnPassengers(sim.passengers, sim.network, deltaTime, sim.seed);
+    sim.arrivalsCount += tickFleet(fleet, deltaTime, sim.network);
+
+    for (int i = 0; i < fleet.arrivedCount; ++i) {
+        serveInspection(sim, fleet.arrivedBuses[i]);
+        serveArrival(sim, fleet.arrivedBuses[i]);
+    }
+
+    int boardings = 0;
+    for (int i = 0; i < fleet.departedCount; ++i)
+        boardings += serveDeparture(sim, fleet.departedBuses[i]);
+    sim.lastTickBoardings = boardings;
+    sim.maxTickBoardings = boardings > sim.maxTickBoardings ? boardings : sim.maxTickBoardings;
+
+    if (timed)
+        recordHistogram(TICK_SECONDS_METRIC, getMetricsClock() - start);
+}
+
+int serveInspection(Simulation& sim, int bus) {
+    bool playerControl = sim.inspectors.busInspector[bus] == PLAYER_INSPECTOR;
+    int fined = finishInspection(sim.inspectors, sim.passengers, sim.fleet, bus);
+
+    if (fined > 0)
+        addCounter(FINED_METRIC, fined);
+    if (fined >= 0)
+        logEvent(LOG_INSPECTION, sim.time, bus, sim.fleet.stationIndex[bus], fined);
+    // Stigli smo do sledece stanice!
+    if (playerControl)
+        logEvent(LOG_PLAYER_PASSENGERS, sim.time, bus, sim.fleet.load[bus], 0);
+    return fined;
+}
+
+int serveArrival(Simulation& sim, int bus) {
+    int station = sim.fleet.stationIndex[bus];
+    int alighted = alightPassengers(sim.passengers, sim.fleet, bus, station);
+    recordHistogram(STOP_ALIGHTINGS_METRIC, (unsigned long long)alighted);
+    if (alighted > 0)
+        logEvent(LOG_ALIGHTING, sim.time, bus, station, alighted);
+    return alighted;
+}
+
+int serveDeparture(Simulation& sim, int bus) {
+    const Fleet& fleet = sim.fleet;
+    int route = fleet.route[bus];
+    int slot = sim.network.routeOffsets[route] + previousRouteStop(sim.network, route, fleet.routeStop[bus]);
+    int boarded = boardPassengers(sim.passengers, sim.fleet, bus, slot, (float)sim.time);
+    recordHistogram(STOP_BOARDINGS_METRIC, (unsigned long long)boarded);
+    if (boarded > 0)
+        logEvent(LOG_BOARDING, sim.time, bus, fleet.fromStation[bus], boarded);
+    boardWaitingInspector(sim.inspectors, fleet, bus);
+    return boarded;
+}
+
+int advanceSimulation(Simulation& sim, double& accumulator, double deltaTime) {
+    if (deltaTime > MAX_FRAME_SECONDS)
+        deltaTime = MAX_FRAME_SECONDS;
+
+    accumulator += deltaTime;
+    int steps = 0;
+    while (accumulator >= SIMULATION_STEP_SECONDS) {
+        stepSimulation(sim, SIMULATION_STEP_SECONDS);
+        accumulator -= SIMULATION_STEP_SECONDS;
+        steps++;
+    }
+    return steps;
+}
+
+bool isPlayerBusWaiting(const Simulation& sim) {
+    return sim.fleet.isWaiting[PLAYER_BUS] != 0;
+}
+
+bool isPlayerBusInspected(const Simulation& sim) {
+    return isBusInspected(sim.inspectors, PLAYER_BUS);
+}
+
+int getPassengersNumber(const Simulation& sim) {
+    return sim.fleet.load[PLAYER_BUS];
+}
+
+// Mesto na liniji (indeks u network.routeStops) stanice na kojoj autobus stoji
+static int getWaitingSlot(const Simulation& sim, int bus) {
+    return sim.network.routeOffsets[sim.fleet.route[bus]] + sim.fleet.routeStop[bus];
+}
+
+// Novi putnik na stanici na kojoj stoji autobus PLAYER_BUS (jos nije u autobusu)
+static int createPlayerPassenger(Simulation& sim) {
+    Passengers& passengers = sim.passengers;
+    RandomStream stream = makeRandomStream(sim.seed, STREAM_PASSENGER, (unsigned int)passengers.spawnedCount);
+    return createPassenger(passengers, sim.network, getWaitingSlot(sim, PLAYER_BUS), stream);
+}
+
+bool addPassenger(Simulation& sim) {
+    int& passengersNumber = sim.fleet.load[PLAYER_BUS];
+    if (!isPlayerBusWaiting(sim) || passengersNumber >= MAX_PASSENGERS)
+        return false;
+    int passenger = createPlayerPassenger(sim);
+    if (passenger < 0)
+        return false;
+    seatPassenger(sim.passengers, sim.fleet, PLAYER_BUS, passenger, (float)sim.time);
+    logEvent(LOG_PLAYER_PASSENGERS, sim.time, PLAYER_BUS, passengersNumber, 0);
+    return true;
+}
+
+bool removePassenger(Simulation& sim) {
+    int& passengersNumber = sim.fleet.load[PLAYER_BUS];
+    if (!isPlayerBusWaiting(sim) || passengersNumber <= 0)
+        return false;
+    removeSeatedPassenger(sim.passengers, sim.fleet, PLAYER_BUS, passengersNumber - 1);
+    logEvent(LOG_PLAYER_PASSENGERS, sim.time, PLAYER_BUS, passengersNumber, 0);
+    return true;
+}
+
+bool startControl(Simulation& sim) {
+    // Kontrolor korisnika ulazi u autobus i izlazi na sledecoj stanici (vidi serveInspection)
+    if (!isPlayerBusWaiting(sim) || !boardInspector(sim.inspectors, PLAYER_INSPECTOR, PLAYER_BUS))
+        return false;
+    logEvent(LOG_CONTROL_START, sim.time, PLAYER_BUS, 0, 0);
+    return true;
+}
+
+void updateSimulationMetrics(const Simulation& sim) {
+    setGauge(PASSENGERS_METRIC, (double)sim.passengers.count);
+    setGauge(SIMULATED_TIME_METRIC, sim.time);
+    setGauge(TICKS_METRIC, (double)sim.tickCount);
+}
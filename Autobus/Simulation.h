@@ -0,0 +1,102 @@
+#pragma once
+#include <vector>
+#include "Network.h"
+#include "Fleet.h"
+#include "Route.h"
+#include "Passengers.h"
+#include "Inspectors.h"
+
+// Jezgro simulacije autobusa - ne zavisi od GLFW/GLEW-a, pa moze da radi i bez prozora
+
+// --- Konstante kretanja ---
+const float TRAVEL_TIME_SECONDS = 5.0f;
+const float STATION_WAIT_SECONDS = 10.0f;
+const int MAX_PASSENGERS = 50;
+
+// --- Podrazumevana mreza (bez --network): jedna linija sa 10 stanica na elipsi ---
+const int NUM_STATIONS = 10;
+const float ROUTE_AXIS_A = 0.8f; // Poluosa a (x)
+const float ROUTE_AXIS_B = 0.5f; // Poluosa b (y)
+
+// Autobus kojim korisnik upravlja (klikovi, kontrola) i ciji se status prikazuje
+const int PLAYER_BUS = 0;
+
+// Fiksni korak simulacije (sekunde simuliranog vremena po tiku)
+const float SIMULATION_STEP_SECONDS = 1.0f / 60.0f;
+
+// Najveci deltaTime koji prihvatamo od prozora (npr. kad se prozor vuce), da ne bismo
+// odjednom izvrsavali hiljade koraka
+const double MAX_FRAME_SECONDS = 0.25;
+
+struct Simulation {
+    // Stanice i linije
+    Network network;
+
+    // Krivudava putanja svakog segmenta mreze
+    RoutePath route;
+
+    // Stanje svih autobusa
+    Fleet fleet;
+
+    // Putnici na stanicama i u autobusima
+    Passengers passengers;
+
+    // Kontrolori karata (i kontrolor korisnika, PLAYER_INSPECTOR)
+    Inspectors inspectors;
+
+    // Seme svih tokova slucajnih brojeva (vidi Random.h)
+    unsigned long long seed = 0;
+
+    // Simulirano vreme i statistika
+    double time = 0.0;
+    long long tickCount = 0;
+    long long arrivalsCount = 0;
+    int lastTickBoardings = 0;   // Broj putnika koji su usli u autobuse u poslednjem koraku
+    int maxTickBoardings = 0;
+};
+
+// Velicine i parametri simulacije (iz komandne linije, vidi getSimulationConfig)
+struct SimulationConfig {
+    int numBuses = 1;
+    int passengerCapacity = DEFAULT_PASSENGER_CAPACITY;
+    double demand = DEFAULT_PASSENGER_DEMAND;      // Putnika u sekundi po stanici linije
+    int numInspectors = 0;
+    int transferPolicy = TRANSFER_NEXT_BUS;
+    unsigned long long seed = 0;
+};
+
+// Preuzima mrezu, pravi putanju kroz nju, postavlja autobuse na stanice, zauzima mesta za
+// putnike i rasporedjuje kontrolore po stanicama
+void initSimulation(Simulation& sim, const Network& network, const SimulationConfig& config);
+
+// Pomera simulaciju za jedan korak od deltaTime sekundi
+// (pozicije autobusa se ne racunaju - to radi updateFleetPositions kad zatrebaju za crtanje)
+void stepSimulation(Simulation& sim, float deltaTime);
+
+// Autobus je stigao na stanicu: kontrolor iz njega (ako ga ima) izbacuje putnike bez karte i
+// izlazi (vidi finishInspection); vraca broj kaznjenih ili -1 ako kontrolora nije bilo
+int serveInspection(Simulation& sim, int bus);
+
+// Autobus je stigao na stanicu (posle serveInspection): izlaze putnici kojima je to odrediste;
+// vraca broj izaslih
+int serveArrival(Simulation& sim, int bus);
+
+// Autobus polazi sa stanice (posle departBus): ulaze putnici iz reda linije na toj stanici, pa
+// kontrolor koji tu ceka; vraca broj putnika koji su usli
+int serveDeparture(Simulation& sim, int bus);
+
+// Trosi akumulirano vreme u fiksnim koracima, vraca broj izvrsenih koraka
+int advanceSimulation(Simulation& sim, double& accumulator, double deltaTime);
+
+// Stanje autobusa kojim korisnik upravlja
+bool isPlayerBusWaiting(const Simulation& sim);
+bool isPlayerBusInspected(const Simulation& sim);
+int getPassengersNumber(const Simulation& sim);
+
+// Ulazi korisnika (dozvoljeni samo dok autobus stoji na stanici)
+bool addPassenger(Simulation& sim);
+bool removePassenger(Simulation& sim);
+bool startControl(Simulation& sim);
+
+// Upisuje trenutno stanje simulacije (broj putnika, simulirano vreme) u merila metrika (vidi Metrics.h)
+void updateSimulationMetrics(const Simulation& sim);
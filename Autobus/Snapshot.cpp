@@ -0,0 +1,693 @@
+#include "Snapshot.h"
+#include "Bits.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Poravnanje svakog niza u fajlu (mapiran fajl pocinje na pocetku stranice, pa su i nizovi poravnati)
+const size_t SNAPSHOT_ALIGNMENT = 64;
+
+// Zastavice u zaglavlju
+const unsigned int SNAPSHOT_HAS_EVENTS = 1;
+
+struct SnapshotHeader {
+    char magic[8];                 // "AUTOSNAP"
+    unsigned int version;
+    unsigned int flags;
+    unsigned long long fileSize;
+    unsigned int endianCheck;      // 0x01020304 na racunaru koji je upisao snimak
+    unsigned int padding;
+};
+
+static const char SNAPSHOT_MAGIC[8] = { 'A', 'U', 'T', 'O', 'S', 'N', 'A', 'P' };
+static const unsigned int SNAPSHOT_ENDIAN_CHECK = 0x01020304;
+
+// Tri prolaza kroz isto stanje (transferSimulation): racunanje velicine, upis u sliku fajla i citanje
+struct SnapshotSizer {
+    size_t offset = 0;
+};
+
+struct SnapshotWriter {
+    char* data = nullptr;
+    size_t offset = 0;
+};
+
+struct SnapshotReader {
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    bool valid = true;
+};
+
+static size_t alignOffset(size_t offset) {
+    return (offset + SNAPSHOT_ALIGNMENT - 1) & ~(SNAPSHOT_ALIGNMENT - 1);
+}
+
+static void transferBytes(SnapshotSizer& sizer, void*, size_t bytes) {
+    sizer.offset += bytes;
+}
+
+static void transferBytes(SnapshotWriter& writer, void* value, size_t bytes) {
+    memcpy(writer.data + writer.offset, value, bytes);
+    writer.offset += bytes;
+}
+
+static void transferBytes(SnapshotReader& reader, void* value, size_t bytes) {
+    if (!reader.valid || reader.size - reader.offset < bytes) {
+        reader.valid = false;
+        return;
+    }
+    memcpy(value, reader.data + reader.offset, bytes);
+    reader.offset += bytes;
+}
+
+template <class Archive, class T>
+static void transferValue(Archive& archive, T& value) {
+    transferBytes(archive, &value, sizeof(T));
+}
+
+// Niz: broj elemenata, pa elementi od sledece poravnate pozicije
+template <class T>
+static void transferArray(SnapshotSizer& sizer, std::vector<T>& values) {
+    sizer.offset = alignOffset(sizer.offset + sizeof(unsigned long long)) + values.size() * sizeof(T);
+}
+
+template <class T>
+static void transferArray(SnapshotWriter& writer, std::vector<T>& values) {
+    unsigned long long count = values.size();
+    transferValue(writer, count);
+    writer.offset = alignOffset(writer.offset);
+    if (count > 0)
+        memcpy(writer.data + writer.offset, values.data(), count * sizeof(T));
+    writer.offset += count * sizeof(T);
+}
+
+template <class T>
+static void transferArray(SnapshotReader& reader, std::vector<T>& values) {
+    unsigned long long count = 0;
+    transferValue(reader, count);
+    reader.offset = alignOffset(reader.offset);
+    if (!reader.valid || reader.offset > reader.size || count > (reader.size - reader.offset) / sizeof(T)) {
+        reader.valid = false;
+        return;
+    }
+    const T* first = (const T*)(reader.data + reader.offset);
+    values.assign(first, first + count);
+    reader.offset += count * sizeof(T);
+}
+
+// Redosled polja u fajlu; isti za sva tri prolaza
+template <class Archive>
+static void transferSimulation(Archive& archive, Simulation& sim) {
+    transferValue(archive, sim.seed);
+    transferValue(archive, sim.time);
+    transferValue(archive, sim.tickCount);
+    transferValue(archive, sim.arrivalsCount);
+    transferValue(archive, sim.lastTickBoardings);
+    transferValue(archive, sim.maxTickBoardings);
+
+    Network& network = sim.network;
+    transferValue(archive, network.numStops);
+    transferValue(archive, network.numRoutes);
+    transferValue(archive, network.numSegments);
+    transferArray(archive, network.stopPositions);
+    transferArray(archive, network.routeOffsets);
+    transferArray(archive, network.routeStops);
+    transferArray(archive, network.routeSegments);
+    transferArray(archive, network.segmentOffsets);
+    transferArray(archive, network.segmentTo);
+
+    RoutePath& route = sim.route;
+    transferValue(archive, route.numSegments);
+    transferArray(archive, route.points);
+    transferArray(archive, route.segmentOffsets);
+    transferArray(archive, route.cumulativeLength);
+    transferArray(archive, route.segmentLength);
+
+    // arrivedBuses i departedBuses vaze samo u toku jednog koraka, pa se ne snimaju
+    Fleet& fleet = sim.fleet;
+    transferValue(archive, fleet.size);
+    transferArray(archive, fleet.route);
+    transferArray(archive, fleet.routeStop);
+    transferArray(archive, fleet.stationIndex);
+    transferArray(archive, fleet.fromStation);
+    transferArray(archive, fleet.segment);
+    transferArray(archive, fleet.segmentTime);
+    transferArray(archive, fleet.waitTimer);
+    transferArray(archive, fleet.isWaiting);
+    transferArray(archive, fleet.load);
+    transferArray(archive, fleet.pathCursor);
+    transferArray(archive, fleet.pathT);
+    transferArray(archive, fleet.posX);
+    transferArray(archive, fleet.posY);
+
+    Passengers& passengers = sim.passengers;
+    transferValue(archive, passengers.capacity);
+    transferValue(archive, passengers.count);
+    transferArray(archive, passengers.origin);
+    transferArray(archive, passengers.destination);
+    transferArray(archive, passengers.hasTicket);
+    transferArray(archive, passengers.boardingTime);
+    transferArray(archive, passengers.next);
+    transferValue(archive, passengers.freeList);
+    transferArray(archive, passengers.seats);
+    transferArray(archive, passengers.ticketBits);
+    transferValue(archive, passengers.demand);
+    transferValue(archive, passengers.spawnAccumulator);
+    transferValue(archive, passengers.spawnedCount);
+    transferValue(archive, passengers.droppedCount);
+    transferValue(archive, passengers.boardedCount);
+    transferValue(archive, passengers.alightedCount);
+    transferValue(archive, passengers.finedCount);
+
+    StopQueues& queues = passengers.queues;
+    transferValue(archive, queues.numQueues);
+    transferArray(archive, queues.blockOffset);
+    transferArray(archive, queues.blockBits);
+    transferArray(archive, queues.head);
+    transferArray(archive, queues.size);
+    transferArray(archive, queues.arena);
+    transferValue(archive, queues.arenaUsed);
+    transferValue(archive, queues.freeBlocks);
+    transferValue(archive, queues.growCount);
+
+    Inspectors& inspectors = sim.inspectors;
+    transferValue(archive, inspectors.count);
+    transferValue(archive, inspectors.policy);
+    transferValue(archive, inspectors.seed);
+    transferArray(archive, inspectors.bus);
+    transferArray(archive, inspectors.stop);
+    transferArray(archive, inspectors.lastBus);
+    transferArray(archive, inspectors.skipped);
+    transferArray(archive, inspectors.nextWaiting);
+    transferArray(archive, inspectors.draws);
+    transferArray(archive, inspectors.busInspector);
+    transferArray(archive, inspectors.waitingHead);
+    transferValue(archive, inspectors.inspectionsCount);
+    transferValue(archive, inspectors.finedCount);
+    transferValue(archive, inspectors.transfersCount);
+}
+
+// Zakazani dogadjaji: ceo tocak tajmera (cvorovi i pregrade) i vremena polazaka i dolazaka
+template <class Archive>
+static void transferEvents(Archive& archive, EventScheduler& scheduler) {
+    TimingWheel& wheel = scheduler.wheel;
+    transferValue(archive, wheel.current);
+    transferArray(archive, wheel.nodes);
+    transferValue(archive, wheel.freeList);
+    transferValue(archive, wheel.count);
+    transferValue(archive, wheel.slotHead);
+    transferValue(archive, wheel.slotTail);
+    transferValue(archive, wheel.occupied);
+    transferValue(archive, wheel.overflowHead);
+    transferValue(archive, wheel.overflowTail);
+
+    transferArray(archive, scheduler.departureTime);
+    transferArray(archive, scheduler.arrivalTime);
+    transferValue(archive, scheduler.processedEvents);
+}
+
+// Provera ucitanog stanja: velicine nizova u skladu sa brojem autobusa, putnika, stanica..., svi
+// sacuvani indeksi u opsegu i povezane liste (slobodni putnici, redovi, kontrolori koji cekaju,
+// pregrade tocka tajmera) bez petlji i preklapanja, da ostecen fajl ne bi doveo do citanja ili
+// pisanja van nizova ni do beskonacne petlje u toku simulacije
+
+// Da li su sve vrednosti u opsegu [low, high)
+static bool isInRange(const std::vector<int>& values, int low, int high) {
+    for (int value : values) {
+        if (value < low || value >= high)
+            return false;
+    }
+    return true;
+}
+
+static bool isFinite(const std::vector<float>& values) {
+    for (float value : values) {
+        if (!std::isfinite(value))
+            return false;
+    }
+    return true;
+}
+
+// Pomeraji CSR liste sa count lista: pocinju od 0, ne opadaju, svaka lista ima bar minLength
+// elemenata, a poslednji je ukupan broj elemenata
+static bool checkOffsets(const std::vector<int>& offsets, int count, int total, int minLength) {
+    if (count < 0 || offsets.size() != (size_t)count + 1 || offsets[0] != 0 || offsets[count] != total)
+        return false;
+    for (int i = 0; i < count; ++i) {
+        if (offsets[i + 1] - offsets[i] < minLength)
+            return false;
+    }
+    return true;
+}
+
+// Skup obelezenih elemenata, bit po elementu (10M putnika je 1.25 MB, pa obelezavanje putnika
+// nasumicnim redom ostaje u kesu)
+struct MarkSet {
+    std::vector<unsigned long long> bits;
+    int count = 0;
+};
+
+// Pomocni skupovi provere. Cuvaju se izmedju ucitavanja (snimak se ucitava samo iz glavne niti), pa
+// ponovno ucitavanje iste velicine ne zauzima memoriju.
+struct CheckScratch {
+    MarkSet seen;   // Putnici, kontrolori ili cvorovi tocka
+    MarkSet owned;  // Delovi arene redova od po 1 << QUEUE_MIN_BLOCK_BITS mesta
+};
+
+static void resetMarks(MarkSet& marks, int count) {
+    marks.count = count;
+    marks.bits.assign(((size_t)count + 63) / 64, 0);
+}
+
+// Obelezava element i; false ako je van opsega ili je vec obelezen (petlja ili deljenje)
+static bool mark(MarkSet& marks, int i) {
+    if ((unsigned)i >= (unsigned)marks.count)
+        return false;
+    unsigned long long& word = marks.bits[i >> 6];
+    unsigned long long bit = 1ULL << (i & 63);
+    if (word & bit)
+        return false;
+    word |= bit;
+    return true;
+}
+
+static bool isMarked(const MarkSet& marks, int i) {
+    return (marks.bits[i >> 6] >> (i & 63)) & 1;
+}
+
+static long long countMarked(const MarkSet& marks) {
+    long long count = 0;
+    for (unsigned long long word : marks.bits)
+        count += countSetBits(word);
+    return count;
+}
+
+static bool checkNetwork(const Network& network) {
+    int slots = (int)network.routeStops.size();
+    return network.numStops > 0 && network.numRoutes > 0 && network.numSegments > 0
+        && network.stopPositions.size() == (size_t)network.numStops * 2 && isFinite(network.stopPositions)
+        && checkOffsets(network.routeOffsets, network.numRoutes, slots, 2)
+        && isInRange(network.routeStops, 0, network.numStops)
+        && network.routeSegments.size() == (size_t)slots && isInRange(network.routeSegments, 0, network.numSegments)
+        && checkOffsets(network.segmentOffsets, network.numStops, network.numSegments, 0)
+        && network.segmentTo.size() == (size_t)network.numSegments && isInRange(network.segmentTo, 0, network.numStops);
+}
+
+// Svaki segment putanje ima bar dve tacke (obe stanice)
+static bool checkRoute(const RoutePath& route, const Network& network) {
+    size_t points = route.points.size() / 2;
+    return route.numSegments == network.numSegments && route.points.size() % 2 == 0
+        && checkOffsets(route.segmentOffsets, route.numSegments, (int)points, 2)
+        && route.cumulativeLength.size() == points && route.segmentLength.size() == (size_t)route.numSegments
+        && isFinite(route.points) && isFinite(route.cumulativeLength) && isFinite(route.segmentLength);
+}
+
+static bool checkFleet(const Fleet& fleet, const Network& network, const RoutePath& route) {
+    size_t buses = (size_t)fleet.size;
+    bool valid = fleet.size > 0 && fleet.route.size() == buses && fleet.routeStop.size() == buses
+        && fleet.stationIndex.size() == buses && fleet.fromStation.size() == buses && fleet.segment.size() == buses
+        && fleet.segmentTime.size() == buses && fleet.waitTimer.size() == buses && fleet.isWaiting.size() == buses
+        && fleet.load.size() == buses && fleet.pathCursor.size() == buses && fleet.pathT.size() == buses
+        && fleet.posX.size() == buses && fleet.posY.size() == buses
+        && isInRange(fleet.route, 0, network.numRoutes)
+        && isInRange(fleet.stationIndex, 0, network.numStops) && isInRange(fleet.fromStation, 0, network.numStops)
+        && isInRange(fleet.segment, 0, network.numSegments) && isInRange(fleet.isWaiting, 0, 2)
+        && isInRange(fleet.load, 0, MAX_PASSENGERS + 1)
+        && isInRange(fleet.pathCursor, 0, (int)route.cumulativeLength.size() - 1)
+        && isFinite(fleet.segmentTime) && isFinite(fleet.waitTimer) && isFinite(fleet.pathT)
+        && isFinite(fleet.posX) && isFinite(fleet.posY);
+    for (size_t i = 0; valid && i < buses; ++i) {
+        int line = fleet.route[i];
+        valid = fleet.routeStop[i] >= 0 && fleet.routeStop[i] < network.routeOffsets[line + 1] - network.routeOffsets[line];
+    }
+    return valid;
+}
+
+// Blokovi redova i slobodni blokovi su unutar zauzetog dela arene i ne preklapaju se; putnici u
+// redovima se obelezavaju u scratch.seen. Arena se zauzima redom, blokovima od bar
+// 1 << QUEUE_MIN_BLOCK_BITS mesta, pa svaki blok pocinje na umnosku te velicine i obelezava se po
+// delovima te velicine umesto mesto po mesto.
+static bool checkQueues(const StopQueues& queues, int numQueues, CheckScratch& scratch) {
+    size_t count = (size_t)numQueues;
+    if (queues.numQueues != numQueues || queues.blockOffset.size() != count || queues.blockBits.size() != count
+        || queues.head.size() != count || queues.size.size() != count
+        || queues.arenaUsed < 0 || (size_t)queues.arenaUsed > queues.arena.size())
+        return false;
+
+    const int unitMask = (1 << QUEUE_MIN_BLOCK_BITS) - 1;
+    resetMarks(scratch.owned, queues.arenaUsed >> QUEUE_MIN_BLOCK_BITS);
+    auto ownBlock = [&](int block, int bits) {
+        if (block < 0 || (block & unitMask) != 0 || bits < QUEUE_MIN_BLOCK_BITS || bits >= QUEUE_SIZE_CLASSES
+            || (long long)block + (1LL << bits) > queues.arenaUsed)
+            return false;
+        int unit = block >> QUEUE_MIN_BLOCK_BITS;
+        for (int i = unit; i < unit + (1 << (bits - QUEUE_MIN_BLOCK_BITS)); ++i) {
+            if (!mark(scratch.owned, i))
+                return false;
+        }
+        return true;
+    };
+
+    for (int q = 0; q < numQueues; ++q) {
+        int block = queues.blockOffset[q];
+        int bits = queues.blockBits[q];
+        int size = queues.size[q];
+        if (block < 0) {
+            if (block != -1 || size != 0)
+                return false;
+            continue;
+        }
+        int head = queues.head[q];
+        if (!ownBlock(block, bits) || head < 0 || head >= 1 << bits || size < 0 || size > 1 << bits)
+            return false;
+        // Red je jedan ili dva uzastopna dela bloka
+        int first = std::min(size, (1 << bits) - head);
+        for (int k = 0; k < first; ++k) {
+            if (!mark(scratch.seen, queues.arena[block + head + k]))
+                return false;
+        }
+        for (int k = 0; k < size - first; ++k) {
+            if (!mark(scratch.seen, queues.arena[block + k]))
+                return false;
+        }
+    }
+    // Blok u listi slobodnih je vec obelezen ako se lista vraca u sebe
+    for (int bits = 0; bits < QUEUE_SIZE_CLASSES; ++bits) {
+        for (int block = queues.freeBlocks[bits]; block != -1; block = queues.arena[block]) {
+            if (!ownBlock(block, bits))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Svaki putnik je tacno na jednom mestu: u listi slobodnih, u redu ili na sedistu autobusa
+static bool checkPassengers(const Passengers& passengers, const Network& network, const Fleet& fleet, CheckScratch& scratch) {
+    size_t capacity = (size_t)passengers.capacity;
+    size_t buses = (size_t)fleet.size;
+    if (passengers.capacity < 0 || passengers.count < 0 || passengers.count > passengers.capacity
+        || passengers.origin.size() != capacity || passengers.destination.size() != capacity
+        || passengers.hasTicket.size() != capacity || passengers.boardingTime.size() != capacity
+        || passengers.next.size() != capacity
+        || passengers.seats.size() != buses * MAX_PASSENGERS
+        || passengers.ticketBits.size() != buses * ((MAX_PASSENGERS + 63) / 64)
+        || !std::isfinite(passengers.demand) || passengers.demand < 0.0
+        || !(passengers.spawnAccumulator >= 0.0 && passengers.spawnAccumulator < 1.0))
+        return false;
+
+    // Kolone putnika u jednom prolazu, bez grananja, da bi se petlja vektorizovala
+    const int* origin = passengers.origin.data();
+    const int* destination = passengers.destination.data();
+    const unsigned char* hasTicket = passengers.hasTicket.data();
+    const float* boardingTime = passengers.boardingTime.data();
+    unsigned int stops = (unsigned int)network.numStops;
+    int invalid = 0;
+    for (int i = 0; i < passengers.capacity; ++i) {
+        invalid |= ((unsigned int)origin[i] >= stops) | ((unsigned int)destination[i] >= stops) | (hasTicket[i] > 1)
+            | !std::isfinite(boardingTime[i]);
+    }
+    if (invalid)
+        return false;
+
+    resetMarks(scratch.seen, passengers.capacity);
+    int freeCount = 0;
+    for (int passenger = passengers.freeList; passenger != -1; passenger = passengers.next[passenger], ++freeCount) {
+        if (!mark(scratch.seen, passenger))
+            return false;
+    }
+    if (!checkQueues(passengers.queues, (int)network.routeStops.size(), scratch))
+        return false;
+    for (size_t bus = 0; bus < buses; ++bus) {
+        for (int k = 0; k < fleet.load[bus]; ++k) {
+            if (!mark(scratch.seen, passengers.seats[bus * MAX_PASSENGERS + k]))
+                return false;
+        }
+    }
+    return countMarked(scratch.seen) == passengers.capacity && passengers.count == passengers.capacity - freeCount;
+}
+
+// Kontrolor u autobusu i autobus sa kontrolorom se slazu, a svaki kontrolor koji ceka je tacno
+// jednom u listi svoje stanice
+static bool checkInspectors(const Inspectors& inspectors, const Network& network, const Fleet& fleet, CheckScratch& scratch) {
+    int total = inspectors.count + 1;
+    size_t count = (size_t)total;
+    if (inspectors.count < 0 || inspectors.policy < TRANSFER_NEXT_BUS || inspectors.policy > TRANSFER_RANDOM_BUS
+        || inspectors.bus.size() != count || inspectors.stop.size() != count || inspectors.lastBus.size() != count
+        || inspectors.skipped.size() != count || inspectors.nextWaiting.size() != count || inspectors.draws.size() != count
+        || inspectors.busInspector.size() != (size_t)fleet.size || inspectors.waitingHead.size() != (size_t)network.numStops
+        || !isInRange(inspectors.bus, -1, fleet.size) || !isInRange(inspectors.stop, -1, network.numStops)
+        || !isInRange(inspectors.lastBus, -1, fleet.size) || !isInRange(inspectors.nextWaiting, -1, total)
+        || !isInRange(inspectors.busInspector, -1, total))
+        return false;
+
+    for (int i = 0; i < total; ++i) {
+        if (inspectors.bus[i] >= 0 && inspectors.busInspector[inspectors.bus[i]] != i)
+            return false;
+    }
+    for (int bus = 0; bus < fleet.size; ++bus) {
+        if (inspectors.busInspector[bus] >= 0 && inspectors.bus[inspectors.busInspector[bus]] != bus)
+            return false;
+    }
+    resetMarks(scratch.seen, total);
+    for (int station = 0; station < network.numStops; ++station) {
+        for (int i = inspectors.waitingHead[station]; i != -1; i = inspectors.nextWaiting[i]) {
+            if (!mark(scratch.seen, i) || inspectors.stop[i] != station)
+                return false;
+        }
+    }
+    for (int i = 0; i < total; ++i) {
+        if ((inspectors.stop[i] >= 0) != isMarked(scratch.seen, i))
+            return false;
+    }
+    return true;
+}
+
+// Lista cvorova tocka od head do tail: veze u oba smera, svaki cvor na nivou level i u pregradi
+// slot (kod liste dalekih dogadjaja pregrada se ne gleda)
+static bool checkTimerList(const TimingWheel& wheel, int head, int tail, int level, int slot,
+    CheckScratch& scratch, int buses) {
+    int previous = -1;
+    for (int node = head; node != -1; node = wheel.nodes[node].next) {
+        const TimerNode& timer = wheel.nodes[node];
+        if (!mark(scratch.seen, node) || timer.prev != previous || timer.level != level
+            || (level < WHEEL_LEVELS && timer.slot != slot) || timer.next < -1 || timer.next >= (int)wheel.nodes.size()
+            || (timer.payload & 3) > EVENT_SPAWN || (timer.payload >> 2) >= (unsigned long long)buses)
+            return false;
+        previous = node;
+    }
+    return previous == tail;
+}
+
+static bool checkEvents(const EventScheduler& scheduler, int buses, CheckScratch& scratch) {
+    const TimingWheel& wheel = scheduler.wheel;
+    size_t count = (size_t)buses;
+    int nodes = (int)wheel.nodes.size();
+    if (scheduler.departureTime.size() != count || scheduler.arrivalTime.size() != count)
+        return false;
+
+    resetMarks(scratch.seen, nodes);
+    for (int level = 0; level < WHEEL_LEVELS; ++level) {
+        for (int slot = 0; slot < WHEEL_SLOTS; ++slot) {
+            int head = wheel.slotHead[level][slot];
+            bool occupied = (wheel.occupied[level][slot >> 6] >> (slot & 63)) & 1;
+            if (head < -1 || head >= nodes || occupied != (head >= 0)
+                || !checkTimerList(wheel, head, wheel.slotTail[level][slot], level, slot, scratch, buses))
+                return false;
+        }
+    }
+    if (wheel.overflowHead < -1 || wheel.overflowHead >= nodes
+        || !checkTimerList(wheel, wheel.overflowHead, wheel.overflowTail, WHEEL_LEVELS, 0, scratch, buses))
+        return false;
+    long long live = countMarked(scratch.seen);
+
+    for (int node = wheel.freeList; node != -1; node = wheel.nodes[node].next) {
+        if (!mark(scratch.seen, node) || wheel.nodes[node].level != -1 || wheel.nodes[node].next < -1 || wheel.nodes[node].next >= nodes)
+            return false;
+    }
+    return countMarked(scratch.seen) == nodes && wheel.count == live;
+}
+
+static bool checkSnapshot(const Simulation& sim, const EventScheduler* scheduler) {
+    static CheckScratch scratch;
+    bool valid = std::isfinite(sim.time) && checkNetwork(sim.network) && checkRoute(sim.route, sim.network)
+        && checkFleet(sim.fleet, sim.network, sim.route) && checkPassengers(sim.passengers, sim.network, sim.fleet, scratch)
+        && checkInspectors(sim.inspectors, sim.network, sim.fleet, scratch);
+    if (valid && scheduler)
+        valid = checkEvents(*scheduler, sim.fleet.size, scratch);
+    return valid;
+}
+
+bool saveSnapshot(const char* path, const Simulation& sim, const EventScheduler* scheduler) {
+    // Prolazi samo citaju stanje, a isti kod sluzi i za ucitavanje
+    Simulation& state = const_cast<Simulation&>(sim);
+    EventScheduler* events = const_cast<EventScheduler*>(scheduler);
+
+    SnapshotSizer sizer;
+    sizer.offset = sizeof(SnapshotHeader);
+    transferSimulation(sizer, state);
+    if (events)
+        transferEvents(sizer, *events);
+
+    std::vector<char> image(sizer.offset);
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.flags = events ? SNAPSHOT_HAS_EVENTS : 0;
+    header.fileSize = image.size();
+    header.endianCheck = SNAPSHOT_ENDIAN_CHECK;
+    header.padding = 0;
+
+    SnapshotWriter writer;
+    writer.data = image.data();
+    transferValue(writer, header);
+    transferSimulation(writer, state);
+    if (events)
+        transferEvents(writer, *events);
+
+    FILE* file = fopen(path, "wb");
+    bool written = file != nullptr && fwrite(image.data(), 1, image.size(), file) == image.size();
+    if (file != nullptr && fclose(file) != 0)
+        written = false;
+    if (!written) {
+        std::cerr << "Greska pri upisu snimka na putanju \"" << path << "\"!" << std::endl;
+        return false;
+    }
+    std::cout << "Snimak upisan na putanju \"" << path << "\" (" << image.size() / (1024.0 * 1024.0) << " MB)" << std::endl;
+    return true;
+}
+
+// Fajl mapiran u memoriju samo za citanje
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int file = -1;
+#endif
+};
+
+static bool mapFile(MappedFile& mapped, const char* path) {
+#ifdef _WIN32
+    mapped.file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (mapped.file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mapped.file, &size) || size.QuadPart == 0)
+        return false;
+    mapped.size = (size_t)size.QuadPart;
+    mapped.mapping = CreateFileMappingA(mapped.file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapped.mapping == NULL)
+        return false;
+    mapped.data = (const char*)MapViewOfFile(mapped.mapping, FILE_MAP_READ, 0, 0, 0);
+    return mapped.data != nullptr;
+#else
+    mapped.file = open(path, O_RDONLY);
+    if (mapped.file < 0)
+        return false;
+    struct stat info;
+    if (fstat(mapped.file, &info) != 0 || info.st_size == 0)
+        return false;
+    mapped.size = (size_t)info.st_size;
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    // Sve stranice se ucitavaju odmah, umesto jedna po jedna pri prvom pristupu
+    flags |= MAP_POPULATE;
+#endif
+    void* data = mmap(nullptr, mapped.size, PROT_READ, flags, mapped.file, 0);
+    if (data == MAP_FAILED)
+        return false;
+    madvise(data, mapped.size, MADV_SEQUENTIAL);
+    mapped.data = (const char*)data;
+    return true;
+#endif
+}
+
+static void unmapFile(MappedFile& mapped) {
+#ifdef _WIN32
+    if (mapped.data != nullptr)
+        UnmapViewOfFile(mapped.data);
+    if (mapped.mapping != NULL)
+        CloseHandle(mapped.mapping);
+    if (mapped.file != INVALID_HANDLE_VALUE)
+        CloseHandle(mapped.file);
+#else
+    if (mapped.data != nullptr)
+        munmap((void*)mapped.data, mapped.size);
+    if (mapped.file >= 0)
+        close(mapped.file);
+#endif
+    mapped = MappedFile();
+}
+
+bool loadSnapshot(const char* path, Simulation& sim, EventScheduler* scheduler) {
+    MappedFile mapped;
+    if (!mapFile(mapped, path)) {
+        unmapFile(mapped);
+        std::cerr << "Greska pri citanju snimka sa putanje \"" << path << "\"!" << std::endl;
+        return false;
+    }
+
+    SnapshotReader reader;
+    reader.data = mapped.data;
+    reader.size = mapped.size;
+    SnapshotHeader header;
+    transferValue(reader, header);
+    if (!reader.valid || memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0
+        || header.endianCheck != SNAPSHOT_ENDIAN_CHECK) {
+        unmapFile(mapped);
+        std::cerr << "Fajl \"" << path << "\" nije snimak simulacije." << std::endl;
+        return false;
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        unmapFile(mapped);
+        std::cerr << "Snimak \"" << path << "\" je verzije " << header.version << ", a podrzana je verzija "
+            << SNAPSHOT_VERSION << "." << std::endl;
+        return false;
+    }
+
+    // Nizovi se kopiraju u postojece nizove sim-a: kad se ucitava u simulaciju iste velicine (npr.
+    // vracanje na sacuvano stanje u toku rada) memorija se ne zauzima ponovo, pa je ucitavanje
+    // samo kopiranje iz mapiranog fajla
+    transferSimulation(reader, sim);
+    bool hasEvents = (header.flags & SNAPSHOT_HAS_EVENTS) != 0;
+    EventScheduler ignoredEvents;
+    EventScheduler& events = scheduler ? *scheduler : ignoredEvents;
+    if (hasEvents)
+        transferEvents(reader, events);
+    bool valid = reader.valid && header.fileSize == mapped.size && checkSnapshot(sim, hasEvents ? &events : nullptr);
+    unmapFile(mapped);
+    if (!valid) {
+        sim = Simulation();
+        events = EventScheduler();
+        std::cerr << "Snimak \"" << path << "\" je ostecen." << std::endl;
+        return false;
+    }
+
+    // Stanice su zamenjene stanicama iz snimka
+    markNetworkChanged(sim.network);
+    sim.fleet.arrivedBuses.resize(sim.fleet.size);
+    sim.fleet.departedBuses.resize(sim.fleet.size);
+    sim.fleet.arrivedCount = 0;
+    sim.fleet.departedCount = 0;
+    if (scheduler && !hasEvents)
+        initEventScheduler(*scheduler, sim);
+    std::cout << "Uspesno procitan snimak sa putanje \"" << path << "\" (vreme " << sim.time << " s, "
+        << sim.fleet.size << " autobusa, " << sim.passengers.count << " putnika)" << std::endl;
+    return true;
+}
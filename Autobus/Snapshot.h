@@ -0,0 +1,22 @@
+#pragma once
+#include "Simulation.h"
+#include "EventScheduler.h"
+
+// Snimak celog stanja simulacije u binarnom fajlu: mreza, putanja, nizovi flote, putnici sa
+// redovima i kartama, kontrolori, seme i brojaci tokova slucajnih brojeva (brojaci su deo stanja
+// putnika i kontrolora, vidi Random.h) i, u radu vodjenom dogadjajima, zakazani dogadjaji.
+//
+// Fajl je zaglavlje pa nizovi jedan za drugim, svaki poravnat na 64 bajta, tacno onako kako su u
+// memoriji. Snimak se pravi u memoriji i upisuje jednim uzastopnim pisanjem; ucitava se mapiranjem
+// fajla u memoriju (mmap / MapViewOfFile), pa se svaki niz prenosi jednim kopiranjem.
+
+const unsigned int SNAPSHOT_VERSION = 1;
+
+// Upisuje snimak u fajl; scheduler je NULL ako simulacija ide fiksnim koracima. U radu vodjenom
+// dogadjajima tajmeri flote moraju biti osvezeni (syncFleetTimers). Vraca false ako pisanje ne uspe.
+bool saveSnapshot(const char* path, const Simulation& sim, const EventScheduler* scheduler);
+
+// Ucitava snimak u sim. Ako scheduler nije NULL, vracaju se i zakazani dogadjaji (a ako ih snimak
+// nema, zakazuju se iz tajmera flote, vidi initEventScheduler). Vraca false (i ispisuje gresku) ako
+// fajl ne postoji, nije snimak ove verzije ili je ostecen.
+bool loadSnapshot(const char* path, Simulation& sim, EventScheduler* scheduler);
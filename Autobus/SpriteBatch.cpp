@@ -0,0 +1,86 @@
+#include "SpriteBatch.h"
+#include "GlState.h"
+#include <GL/glew.h>
+#include <algorithm>
+
+const int SPRITE_VERTEX_FLOATS = 4;
+
+bool createSpriteBatch(SpriteBatch& batch, int capacity, bool allowPersistent) {
+    destroySpriteBatch(batch);
+    size_t regionBytes = sizeof(float) * SPRITE_VERTEX_FLOATS * SPRITE_VERTICES * (size_t)capacity;
+    if (capacity <= 0 || !createInstanceStream(batch.stream, regionBytes, allowPersistent))
+        return false;
+    batch.capacity = capacity;
+    glGenVertexArrays(1, &batch.VAO);
+    bindVertexArray(batch.VAO);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    bindVertexArray(0);
+    return true;
+}
+
+void destroySpriteBatch(SpriteBatch& batch) {
+    destroyInstanceStream(batch.stream);
+    if (batch.VAO != 0)
+        deleteVertexArray(batch.VAO);
+    batch = SpriteBatch();
+}
+
+void addSprite(SpriteBatch& batch, const AtlasRegion& region, float x, float y, float width, float height, int layer) {
+    Sprite sprite;
+    sprite.x0 = x - width / 2.0f;
+    sprite.y0 = y - height / 2.0f;
+    sprite.x1 = x + width / 2.0f;
+    sprite.y1 = y + height / 2.0f;
+    sprite.u0 = region.u0;
+    sprite.v0 = region.v0;
+    sprite.u1 = region.u1;
+    sprite.v1 = region.v1;
+    sprite.layer = layer;
+    batch.sprites.push_back(sprite);
+}
+
+static float* writeVertex(float* out, float x, float y, float u, float v) {
+    out[0] = x;
+    out[1] = y;
+    out[2] = u;
+    out[3] = v;
+    return out + SPRITE_VERTEX_FLOATS;
+}
+
+int drawSpriteBatch(SpriteBatch& batch) {
+    std::vector<Sprite>& sprites = batch.sprites;
+    std::stable_sort(sprites.begin(), sprites.end(),
+        [](const Sprite& a, const Sprite& b) { return a.layer < b.layer; });
+
+    int calls = 0;
+    bindVertexArray(batch.VAO);
+    for (size_t first = 0; first < sprites.size(); first += batch.capacity) {
+        size_t count = std::min(sprites.size() - first, (size_t)batch.capacity);
+        float* out = (float*)beginInstanceStream(batch.stream);
+        for (size_t i = first; i < first + count; ++i) {
+            const Sprite& s = sprites[i];
+            out = writeVertex(out, s.x0, s.y0, s.u0, s.v0);
+            out = writeVertex(out, s.x1, s.y0, s.u1, s.v0);
+            out = writeVertex(out, s.x1, s.y1, s.u1, s.v1);
+            out = writeVertex(out, s.x0, s.y0, s.u0, s.v0);
+            out = writeVertex(out, s.x1, s.y1, s.u1, s.v1);
+            out = writeVertex(out, s.x0, s.y1, s.u0, s.v1);
+        }
+        size_t bytes = sizeof(float) * SPRITE_VERTEX_FLOATS * SPRITE_VERTICES * count;
+        size_t offset = endInstanceStream(batch.stream, bytes);
+
+        GLsizei stride = SPRITE_VERTEX_FLOATS * sizeof(float);
+        bindArrayBuffer(batch.stream.buffer);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 2 * sizeof(float)));
+        drawArrays(GL_TRIANGLES, 0, (int)(SPRITE_VERTICES * count));
+        fenceInstanceStream(batch.stream);
+        calls++;
+    }
+
+    batch.drawCalls += calls;
+    batch.spritesDrawn += sprites.size();
+    sprites.clear();
+    return calls;
+}
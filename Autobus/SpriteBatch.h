@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include "Atlas.h"
+#include "InstanceStream.h"
+
+// Spritovi (pravougaonici sa slikom iz atlasa) koji se u frejmu skupljaju pa crtaju jednim pozivom:
+// drawSpriteBatch ih poreda po sloju (manji sloj se crta pre, isti sloj redom dodavanja), upisuje
+// po dva trougla za svaki u tok instanci (InstanceStream.h) i crta sve iz istog bafera. Spritovi
+// dele sejder i teksturu (atlas), pa izmedju njih nema promene stanja. Ako ih ima vise od
+// kapaciteta, crtaju se u vise poziva od po capacity.
+
+const int SPRITE_VERTICES = 6;   // Dva trougla po spritu (GL_TRIANGLES)
+
+struct Sprite {
+    float x0, y0, x1, y1;   // Pravougaonik na ekranu (NDC)
+    float u0, v0, u1, v1;   // Region u atlasu
+    int layer;
+};
+
+struct SpriteBatch {
+    unsigned int VAO = 0;
+    InstanceStream stream;       // Temena: x, y, u, v
+    int capacity = 0;            // Najvise spritova po pozivu crtanja
+    std::vector<Sprite> sprites; // Dodati od poslednjeg crtanja
+    long long drawCalls = 0;
+    long long spritesDrawn = 0;
+};
+
+bool createSpriteBatch(SpriteBatch& batch, int capacity, bool allowPersistent);
+void destroySpriteBatch(SpriteBatch& batch);
+
+// Sprite sa centrom (x, y) i velicinom width x height u NDC
+void addSprite(SpriteBatch& batch, const AtlasRegion& region, float x, float y, float width, float height, int layer);
+
+// Crta i prazni dodate spritove; sejder (atributi 0: pozicija, 1: teksturne koordinate) i atlas
+// moraju biti aktivni. Vraca broj poziva crtanja.
+int drawSpriteBatch(SpriteBatch& batch);
@@ -0,0 +1,90 @@
+#include "StopQueues.h"
+#include <cstring>
+
+void initStopQueues(StopQueues& queues, int numQueues, int arenaCapacity) {
+    queues.numQueues = numQueues;
+    queues.blockOffset.assign(numQueues, -1);
+    queues.blockBits.assign(numQueues, 0);
+    queues.head.assign(numQueues, 0);
+    queues.size.assign(numQueues, 0);
+    queues.arena.assign(arenaCapacity, 0);
+    queues.arenaUsed = 0;
+    queues.growCount = 0;
+    for (int i = 0; i < QUEUE_SIZE_CLASSES; ++i)
+        queues.freeBlocks[i] = -1;
+}
+
+static int allocateBlock(StopQueues& queues, int bits) {
+    int block = queues.freeBlocks[bits];
+    if (block >= 0) {
+        queues.freeBlocks[bits] = queues.arena[block];
+        return block;
+    }
+
+    // Nema slobodnog bloka te velicine: uzimamo nov sa kraja arene (arena raste samo dok se redovi zagrevaju)
+    int blockSize = 1 << bits;
+    if (queues.arenaUsed + blockSize > (int)queues.arena.size()) {
+        size_t grown = queues.arena.size() * 2;
+        queues.arena.resize(grown > (size_t)(queues.arenaUsed + blockSize) ? grown : (size_t)(queues.arenaUsed + blockSize));
+    }
+    block = queues.arenaUsed;
+    queues.arenaUsed += blockSize;
+    return block;
+}
+
+static void freeBlock(StopQueues& queues, int block, int bits) {
+    queues.arena[block] = queues.freeBlocks[bits];
+    queues.freeBlocks[bits] = block;
+}
+
+// Prelazak u dvostruko veci blok; elementi se prepisuju redom, od pocetka novog bloka
+static void growQueue(StopQueues& queues, int queue) {
+    int oldBlock = queues.blockOffset[queue];
+    int oldBits = queues.blockBits[queue];
+    int bits = oldBlock < 0 ? QUEUE_MIN_BLOCK_BITS : oldBits + 1;
+    int block = allocateBlock(queues, bits);
+
+    if (oldBlock >= 0) {
+        int* arena = queues.arena.data();
+        int oldSize = 1 << oldBits;
+        int head = queues.head[queue];
+        int count = queues.size[queue];
+        int first = count < oldSize - head ? count : oldSize - head;
+        memcpy(arena + block, arena + oldBlock + head, first * sizeof(int));
+        memcpy(arena + block + first, arena + oldBlock, (count - first) * sizeof(int));
+        freeBlock(queues, oldBlock, oldBits);
+        queues.growCount++;
+    }
+
+    queues.blockOffset[queue] = block;
+    queues.blockBits[queue] = bits;
+    queues.head[queue] = 0;
+}
+
+void pushQueue(StopQueues& queues, int queue, int value) {
+    int count = queues.size[queue];
+    if (queues.blockOffset[queue] < 0 || count == 1 << queues.blockBits[queue])
+        growQueue(queues, queue);
+
+    int mask = (1 << queues.blockBits[queue]) - 1;
+    queues.arena[queues.blockOffset[queue] + ((queues.head[queue] + count) & mask)] = value;
+    queues.size[queue] = count + 1;
+}
+
+int popQueue(StopQueues& queues, int queue, int* out, int maxCount) {
+    int count = queues.size[queue] < maxCount ? queues.size[queue] : maxCount;
+    if (count <= 0)
+        return 0;
+
+    // Najvise dva uzastopna dela: do kraja bloka, pa od njegovog pocetka
+    const int* block = queues.arena.data() + queues.blockOffset[queue];
+    int blockSize = 1 << queues.blockBits[queue];
+    int head = queues.head[queue];
+    int first = count < blockSize - head ? count : blockSize - head;
+    memcpy(out, block + head, first * sizeof(int));
+    memcpy(out + first, block, (count - first) * sizeof(int));
+
+    queues.head[queue] = (head + count) & (blockSize - 1);
+    queues.size[queue] -= count;
+    return count;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+
+// Redovi cekanja na stanicama kao kruzni baferi (ring buffer). Svaki red ima blok velicine stepena
+// dvojke u jednom zajednickom nizu (arena); kad se napuni, prelazi u dvostruko veci blok, a stari
+// blok ide u listu slobodnih blokova svoje velicine i ponovo se koristi. Posle zagrevanja redovi
+// zato vise ne zauzimaju memoriju, a ulazak u autobus je kopiranje jednog ili dva uzastopna dela
+// bloka umesto pracenja pokazivaca od putnika do putnika.
+
+const int QUEUE_MIN_BLOCK_BITS = 4;   // Najmanji blok: 16 mesta
+const int QUEUE_SIZE_CLASSES = 31;
+
+struct StopQueues {
+    int numQueues = 0;
+    std::vector<int> blockOffset;     // Pocetak bloka reda u areni (-1 dok red nema blok)
+    std::vector<int> blockBits;       // Velicina bloka je 1 << blockBits
+    std::vector<int> head;            // Prvi u redu (indeks u bloku)
+    std::vector<int> size;            // Broj elemenata u redu
+
+    std::vector<int> arena;
+    int arenaUsed = 0;
+    int freeBlocks[QUEUE_SIZE_CLASSES]; // Prvi slobodan blok svake velicine; u bloku pise sledeci
+    long long growCount = 0;            // Koliko puta je neki red presao u veci blok
+};
+
+// numQueues praznih redova, sa arenom od arenaCapacity mesta unapred
+void initStopQueues(StopQueues& queues, int numQueues, int arenaCapacity);
+
+// Dodaje vrednost na kraj reda
+void pushQueue(StopQueues& queues, int queue, int value);
+
+// Skida do maxCount vrednosti sa pocetka reda u out (redom), vraca koliko je skinuto
+int popQueue(StopQueues& queues, int queue, int* out, int maxCount);
+
+inline int getQueueSize(const StopQueues& queues, int queue) {
+    return queues.size[queue];
+}
@@ -0,0 +1,368 @@
+#include "Telemetry.h"
+#include "Profiler.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+static const char TELEMETRY_MAGIC[8] = { 'A', 'U', 'T', 'O', 'T', 'E', 'L', 'M' };
+const unsigned int TELEMETRY_VERSION = 1;
+
+// Koliko pozadinska nit spava kad nema punih blokova
+const int TELEMETRY_WRITER_SLEEP_MICROSECONDS = 1000;
+
+// Kolone bloka: vreme, segment, predjeni deo, putnici
+const int TELEMETRY_COLUMNS = 4;
+
+struct TelemetryFileHeader {
+    char magic[8];
+    unsigned int version;
+    int numBuses;
+    double intervalSeconds;
+};
+
+// Iza zaglavlja bloka su kolone jedna za drugom (columnBytes bajtova svaka)
+struct TelemetryChunkHeader {
+    unsigned int samples;
+    unsigned int numBuses;
+    unsigned int columnBytes[TELEMETRY_COLUMNS];
+};
+
+// Blok koji simulacija puni, a pozadinska nit kodira (uzorci jedan za drugim, numBuses redova u svakom)
+struct TelemetryBuffer {
+    int samples = 0;
+    std::vector<long long> timeMs;
+    std::vector<int> segment;
+    std::vector<int> progress;
+    std::vector<int> load;
+};
+
+static std::atomic<bool> telemetryEnabled(false);
+static std::atomic<bool> writerRunning(false);
+static std::thread writerThread;
+static FILE* telemetryFile = nullptr;
+static int telemetryBuses = 0;
+static int chunkSamples = 0;
+static double telemetryInterval = TELEMETRY_INTERVAL_SECONDS;
+static bool waitForWriter = false;
+
+// Blok k je buffers[k % TELEMETRY_CHUNK_BUFFERS]; simulacija predaje blokove (submittedChunks), a
+// pozadinska nit ih oslobadja kad ih upise (writtenChunks)
+static TelemetryBuffer buffers[TELEMETRY_CHUNK_BUFFERS];
+static std::atomic<long long> submittedChunks(0);
+static std::atomic<long long> writtenChunks(0);
+static std::atomic<long long> writtenBytes(0);
+static std::atomic<long long> writerNanoseconds(0);
+
+// Stanje simulacije (menja ga samo nit koja poziva recordTelemetry)
+static TelemetryBuffer* fillBuffer = nullptr;
+static double nextSampleTime = 0.0;
+static bool firstSample = true;
+static long long sampleCount = 0;
+static long long droppedSamples = 0;
+
+// Kodirane kolone (samo pozadinska nit), zauzete za najgori slucaj pri pokretanju
+static std::vector<unsigned char> encoded[TELEMETRY_COLUMNS];
+
+static inline unsigned long long zigzag(long long value) {
+    return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+}
+
+static inline long long unzigzag(unsigned long long value) {
+    return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+static inline unsigned char* putVarint(unsigned char* out, unsigned long long value) {
+    while (value >= 0x80) {
+        *out++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (unsigned char)value;
+    return out;
+}
+
+// Kolona flote: razlika od istog autobusa u prethodnom uzorku
+static unsigned int encodeColumn(const std::vector<int>& column, int samples, int numBuses, unsigned char* out) {
+    unsigned char* begin = out;
+    const int* values = column.data();
+    for (int i = 0; i < numBuses; ++i)
+        out = putVarint(out, zigzag(values[i]));
+    for (int s = 1; s < samples; ++s) {
+        const int* row = values + (size_t)s * numBuses;
+        const int* previous = row - numBuses;
+        for (int i = 0; i < numBuses; ++i)
+            out = putVarint(out, zigzag((long long)row[i] - previous[i]));
+    }
+    return (unsigned int)(out - begin);
+}
+
+static void writeChunk(const TelemetryBuffer& buffer) {
+    PROFILE_FUNCTION();
+    TelemetryChunkHeader header;
+    header.samples = (unsigned int)buffer.samples;
+    header.numBuses = (unsigned int)telemetryBuses;
+
+    unsigned char* out = encoded[0].data();
+    long long previousTime = 0;
+    for (int s = 0; s < buffer.samples; ++s) {
+        out = putVarint(out, zigzag(buffer.timeMs[s] - previousTime));
+        previousTime = buffer.timeMs[s];
+    }
+    header.columnBytes[0] = (unsigned int)(out - encoded[0].data());
+    header.columnBytes[1] = encodeColumn(buffer.segment, buffer.samples, telemetryBuses, encoded[1].data());
+    header.columnBytes[2] = encodeColumn(buffer.progress, buffer.samples, telemetryBuses, encoded[2].data());
+    header.columnBytes[3] = encodeColumn(buffer.load, buffer.samples, telemetryBuses, encoded[3].data());
+
+    long long bytes = sizeof(header);
+    fwrite(&header, sizeof(header), 1, telemetryFile);
+    for (int c = 0; c < TELEMETRY_COLUMNS; ++c) {
+        fwrite(encoded[c].data(), 1, header.columnBytes[c], telemetryFile);
+        bytes += header.columnBytes[c];
+    }
+    writtenBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+// Upisuje predate blokove; posle zaustavljanja upisuje preostale i izlazi
+static void runTelemetryWriter() {
+    PROFILE_THREAD("telemetrija");
+    for (;;) {
+        long long written = writtenChunks.load(std::memory_order_relaxed);
+        if (written < submittedChunks.load(std::memory_order_acquire)) {
+            auto start = std::chrono::steady_clock::now();
+            writeChunk(buffers[written % TELEMETRY_CHUNK_BUFFERS]);
+            writerNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+            writtenChunks.store(written + 1, std::memory_order_release);
+        }
+        else if (!writerRunning.load(std::memory_order_acquire))
+            break;
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(TELEMETRY_WRITER_SLEEP_MICROSECONDS));
+    }
+}
+
+bool startTelemetry(const char* path, int numBuses, double intervalSeconds, bool waitWhenBehind) {
+    if (telemetryEnabled.load())
+        stopTelemetry();
+    telemetryFile = fopen(path, "wb");
+    if (telemetryFile == nullptr) {
+        std::cerr << "Greska pri otvaranju fajla telemetrije \"" << path << "\"!" << std::endl;
+        return false;
+    }
+
+    TelemetryFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TELEMETRY_MAGIC, sizeof(header.magic));
+    header.version = TELEMETRY_VERSION;
+    header.numBuses = numBuses;
+    header.intervalSeconds = intervalSeconds;
+    fwrite(&header, sizeof(header), 1, telemetryFile);
+
+    // Sva memorija se zauzima ovde: blokovi i kodirane kolone za najgori slucaj (varint razlike
+    // dva int-a ima najvise 5 bajtova, vremena najvise 10)
+    telemetryBuses = numBuses;
+    telemetryInterval = intervalSeconds;
+    waitForWriter = waitWhenBehind;
+    int rowsPerSample = numBuses > 0 ? numBuses : 1;
+    chunkSamples = TELEMETRY_CHUNK_ROWS / rowsPerSample;
+    chunkSamples = chunkSamples < 1 ? 1 : (chunkSamples > TELEMETRY_CHUNK_MAX_SAMPLES ? TELEMETRY_CHUNK_MAX_SAMPLES : chunkSamples);
+    size_t rows = (size_t)chunkSamples * numBuses;
+    for (int b = 0; b < TELEMETRY_CHUNK_BUFFERS; ++b) {
+        buffers[b].samples = 0;
+        buffers[b].timeMs.assign(chunkSamples, 0);
+        buffers[b].segment.assign(rows, 0);
+        buffers[b].progress.assign(rows, 0);
+        buffers[b].load.assign(rows, 0);
+    }
+    encoded[0].assign((size_t)chunkSamples * 10, 0);
+    for (int c = 1; c < TELEMETRY_COLUMNS; ++c)
+        encoded[c].assign(rows * 5, 0);
+
+    submittedChunks = 0;
+    writtenChunks = 0;
+    writtenBytes = sizeof(header);
+    writerNanoseconds = 0;
+    fillBuffer = nullptr;
+    firstSample = true;
+    sampleCount = 0;
+    droppedSamples = 0;
+    writerRunning = true;
+    writerThread = std::thread(runTelemetryWriter);
+    telemetryEnabled = true;
+    return true;
+}
+
+void recordTelemetry(const Simulation& sim) {
+    if (!telemetryEnabled.load(std::memory_order_relaxed))
+        return;
+    if (!firstSample && sim.time + 1e-6 < nextSampleTime)
+        return;
+    // Posle dugog koraka (ili frejma) sledeci uzorak je interval posle ovog, bez sustizanja
+    nextSampleTime = firstSample ? sim.time + telemetryInterval : nextSampleTime + telemetryInterval;
+    if (nextSampleTime <= sim.time)
+        nextSampleTime = sim.time + telemetryInterval;
+    firstSample = false;
+    sampleCount++;
+
+    if (fillBuffer == nullptr) {
+        long long submitted = submittedChunks.load(std::memory_order_relaxed);
+        while (waitForWriter && submitted - writtenChunks.load(std::memory_order_acquire) >= TELEMETRY_CHUNK_BUFFERS)
+            std::this_thread::sleep_for(std::chrono::microseconds(TELEMETRY_WRITER_SLEEP_MICROSECONDS / 10));
+        if (submitted - writtenChunks.load(std::memory_order_acquire) >= TELEMETRY_CHUNK_BUFFERS) {
+            droppedSamples++;
+            return;
+        }
+        fillBuffer = &buffers[submitted % TELEMETRY_CHUNK_BUFFERS];
+        fillBuffer->samples = 0;
+    }
+
+    const Fleet& fleet = sim.fleet;
+    const int n = telemetryBuses < fleet.size ? telemetryBuses : fleet.size;
+    int sample = fillBuffer->samples;
+    size_t offset = (size_t)sample * telemetryBuses;
+    fillBuffer->timeMs[sample] = (long long)floor(sim.time * 1000.0 + 0.5);
+    memcpy(fillBuffer->segment.data() + offset, fleet.segment.data(), n * sizeof(int));
+    memcpy(fillBuffer->load.data() + offset, fleet.load.data(), n * sizeof(int));
+    int* progress = fillBuffer->progress.data() + offset;
+    const float* segmentTime = fleet.segmentTime.data();
+    const float scale = (float)TELEMETRY_PROGRESS_SCALE / TRAVEL_TIME_SECONDS;
+    for (int i = 0; i < n; ++i) {
+        float value = segmentTime[i] * scale;
+        progress[i] = (int)((value < (float)TELEMETRY_PROGRESS_SCALE ? value : (float)TELEMETRY_PROGRESS_SCALE) + 0.5f);
+    }
+
+    fillBuffer->samples = sample + 1;
+    if (fillBuffer->samples == chunkSamples) {
+        submittedChunks.fetch_add(1, std::memory_order_release);
+        fillBuffer = nullptr;
+    }
+}
+
+double getNextTelemetryTime() {
+    return nextSampleTime;
+}
+
+void stopTelemetry() {
+    if (!telemetryEnabled.load())
+        return;
+    telemetryEnabled = false;
+    if (fillBuffer != nullptr && fillBuffer->samples > 0)
+        submittedChunks.fetch_add(1, std::memory_order_release);
+    fillBuffer = nullptr;
+    writerRunning = false;
+    writerThread.join();
+    fclose(telemetryFile);
+    telemetryFile = nullptr;
+}
+
+bool isTelemetryEnabled() {
+    return telemetryEnabled.load(std::memory_order_relaxed);
+}
+
+TelemetryStats getTelemetryStats() {
+    TelemetryStats stats;
+    stats.samples = sampleCount;
+    stats.droppedSamples = droppedSamples;
+    stats.chunks = writtenChunks.load();
+    stats.bytes = writtenBytes.load();
+    stats.writerSeconds = writerNanoseconds.load() * 1e-9;
+    for (int b = 0; b < TELEMETRY_CHUNK_BUFFERS; ++b)
+        stats.memoryBytes += (long long)(buffers[b].timeMs.capacity() * sizeof(long long)
+            + (buffers[b].segment.capacity() + buffers[b].progress.capacity() + buffers[b].load.capacity()) * sizeof(int));
+    for (int c = 0; c < TELEMETRY_COLUMNS; ++c)
+        stats.memoryBytes += (long long)encoded[c].capacity();
+    return stats;
+}
+
+// Cita count varint-ova iz [in, end); vraca false ako ih nema tacno toliko
+static bool decodeColumn(const unsigned char* in, const unsigned char* end, long long* values, size_t count) {
+    for (size_t k = 0; k < count; ++k) {
+        unsigned long long value = 0;
+        int shift = 0;
+        for (;;) {
+            if (in == end || shift > 63)
+                return false;
+            unsigned char byte = *in++;
+            value |= (unsigned long long)(byte & 0x7f) << shift;
+            shift += 7;
+            if ((byte & 0x80) == 0)
+                break;
+        }
+        values[k] = unzigzag(value);
+    }
+    return in == end;
+}
+
+// Razlike od istog autobusa u prethodnom uzorku u vrednosti
+static void undoDeltas(const std::vector<long long>& deltas, std::vector<int>& column, int samples, int numBuses) {
+    column.resize((size_t)samples * numBuses);
+    for (int i = 0; i < numBuses && samples > 0; ++i)
+        column[i] = (int)deltas[i];
+    for (size_t k = numBuses; k < column.size(); ++k)
+        column[k] = (int)(column[k - numBuses] + deltas[k]);
+}
+
+bool readTelemetry(const char* path, void (*onChunk)(void* user, const TelemetryChunk& chunk), void* user) {
+    FILE* file = fopen(path, "rb");
+    TelemetryFileHeader header;
+    bool valid = file != nullptr && fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, TELEMETRY_MAGIC, sizeof(header.magic)) == 0
+        && header.version == TELEMETRY_VERSION && header.numBuses >= 0;
+
+    TelemetryChunk chunk;
+    chunk.numBuses = valid ? header.numBuses : 0;
+    std::vector<unsigned char> bytes;
+    std::vector<long long> deltas;
+    TelemetryChunkHeader chunkHeader;
+    while (valid && fread(&chunkHeader, sizeof(chunkHeader), 1, file) == 1) {
+        valid = (int)chunkHeader.numBuses == header.numBuses && chunkHeader.samples > 0
+            && chunkHeader.samples <= (unsigned int)TELEMETRY_CHUNK_MAX_SAMPLES;
+        if (!valid)
+            break;
+        chunk.samples = (int)chunkHeader.samples;
+        size_t rows = (size_t)chunk.samples * chunk.numBuses;
+        for (int c = 0; c < TELEMETRY_COLUMNS && valid; ++c) {
+            size_t count = c == 0 ? (size_t)chunk.samples : rows;
+            bytes.resize(chunkHeader.columnBytes[c]);
+            deltas.resize(count);
+            valid = (bytes.empty() || fread(bytes.data(), 1, bytes.size(), file) == bytes.size())
+                && decodeColumn(bytes.data(), bytes.data() + bytes.size(), deltas.data(), count);
+            if (!valid)
+                break;
+            if (c == 0) {
+                chunk.timeMs.resize(count);
+                long long time = 0;
+                for (size_t k = 0; k < count; ++k)
+                    chunk.timeMs[k] = time += deltas[k];
+            }
+            else
+                undoDeltas(deltas, c == 1 ? chunk.segment : (c == 2 ? chunk.progress : chunk.load), chunk.samples, chunk.numBuses);
+        }
+        if (valid)
+            onChunk(user, chunk);
+    }
+    valid = valid && feof(file);
+    if (file != nullptr)
+        fclose(file);
+    if (!valid)
+        std::cerr << "Fajl \"" << path << "\" nije ispravna telemetrija." << std::endl;
+    return valid;
+}
+
+static void printChunk(void*, const TelemetryChunk& chunk) {
+    for (int s = 0; s < chunk.samples; ++s) {
+        double time = chunk.timeMs[s] / 1000.0;
+        size_t offset = (size_t)s * chunk.numBuses;
+        for (int i = 0; i < chunk.numBuses; ++i)
+            printf("%.3f,%d,%d,%.3f,%d\n", time, i, chunk.segment[offset + i],
+                (double)chunk.progress[offset + i] / TELEMETRY_PROGRESS_SCALE, chunk.load[offset + i]);
+    }
+}
+
+int formatTelemetry(const char* path) {
+    printf("time,bus,segment,progress,load\n");
+    return readTelemetry(path, printChunk, nullptr) ? 0 : -1;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "Simulation.h"
+
+// Telemetrija flote: stanje svih autobusa (segment, predjeni deo segmenta, broj putnika) u
+// pravilnim razmacima simuliranog vremena, za analizu putanja van programa (--telemetry <fajl>,
+// citljiv ispis: --format-telemetry <fajl>).
+//
+// Simulacija samo kopira kolone flote u blok koji se puni (bez zauzimanja memorije);
+// pun blok preuzima pozadinska nit, koja ga kodira i upisuje. Blokova ima TELEMETRY_CHUNK_BUFFERS,
+// pa je memorija ogranicena bez obzira na trajanje. Ako pozadinska nit zaostane za svim blokovima,
+// uzorci se odbacuju i broje, a simulacija nastavlja (prozor); bez prozora simulacija nije vezana
+// za stvarno vreme, pa tada moze i da saceka slobodan blok (waitWhenBehind).
+//
+// Fajl je zaglavlje pa blokovi. Blok je niz uzoraka cele flote sa kolonama jedna za drugom: vreme
+// uzorka (milisekunde), pa segment, predjeni deo segmenta (u hiljaditim delovima) i broj putnika za
+// svaki autobus svakog uzorka. Broj autobusa je redni broj reda u uzorku, pa se ne upisuje. Svaka
+// vrednost je razlika od vrednosti istog autobusa u prethodnom uzorku bloka (vreme: od prethodnog
+// uzorka), zapisana kao zigzag varint - autobus koji vozi ili stoji menja vrednosti za malo, pa je
+// vecina vrednosti jedan bajt. Prvi uzorak bloka je razlika od nule, da bi se svaki blok mogao
+// citati zasebno.
+
+// Podrazumevani razmak uzoraka (10 Hz)
+const double TELEMETRY_INTERVAL_SECONDS = 0.1;
+
+// Predjeni deo segmenta se upisuje kao ceo broj 0..TELEMETRY_PROGRESS_SCALE
+const int TELEMETRY_PROGRESS_SCALE = 1000;
+
+// Najvise redova (autobus-uzoraka) u bloku, najvise uzoraka u bloku i broj blokova
+const int TELEMETRY_CHUNK_ROWS = 1 << 20;
+const int TELEMETRY_CHUNK_MAX_SAMPLES = 600;
+const int TELEMETRY_CHUNK_BUFFERS = 4;
+
+// Pokrece pozadinsku nit i otvara fajl za flotu od numBuses autobusa; vraca false ako fajl ne
+// moze da se otvori
+bool startTelemetry(const char* path, int numBuses, double intervalSeconds, bool waitWhenBehind);
+
+// Uzima uzorak flote ako je od poslednjeg proslo bar intervalSeconds (najvise jedan po pozivu);
+// poziva se posle koraka simulacije (u simulaciji dogadjaja posle syncFleetTimers)
+void recordTelemetry(const Simulation& sim);
+
+// Simulirano vreme sledeceg uzorka
+double getNextTelemetryTime();
+
+// Upisuje zapoceti blok, zaustavlja pozadinsku nit i zatvara fajl
+void stopTelemetry();
+
+// Da li je telemetrija pokrenuta
+bool isTelemetryEnabled();
+
+// Statistika od pokretanja
+struct TelemetryStats {
+    long long samples = 0;          // Uzetih uzoraka
+    long long droppedSamples = 0;   // Odbacenih, jer nije bilo slobodnog bloka
+    long long chunks = 0;           // Upisanih blokova
+    long long bytes = 0;            // Velicina fajla
+    long long memoryBytes = 0;      // Memorija blokova (ne raste sa trajanjem)
+    double writerSeconds = 0.0;     // Vreme pozadinske niti provedeno u kodiranju i upisu
+};
+TelemetryStats getTelemetryStats();
+
+// Jedan procitan blok: uzorci jedan za drugim, u svakom numBuses redova
+struct TelemetryChunk {
+    int numBuses = 0;
+    int samples = 0;
+    std::vector<long long> timeMs;
+    std::vector<int> segment;
+    std::vector<int> progress;
+    std::vector<int> load;
+};
+
+// Cita fajl telemetrije blok po blok i za svaki poziva onChunk; vraca false ako fajl nije ispravan
+bool readTelemetry(const char* path, void (*onChunk)(void* user, const TelemetryChunk& chunk), void* user);
+
+// Ispisuje telemetriju kao CSV (vreme, autobus, segment, predjeni deo, putnici), vraca -1 ako fajl
+// nije ispravan
+int formatTelemetry(const char* path);
@@ -0,0 +1,243 @@
+#include "TimingWheel.h"
+#include "Bits.h"
+
+// Broj tikova koje pokriva ceo tocak (256^WHEEL_LEVELS)
+const int WHEEL_RANGE_BITS = WHEEL_LEVELS * WHEEL_SLOT_BITS;
+
+// Prva zauzeta pregrada sa indeksom >= from, ili -1
+static int findNextSlot(const unsigned long long* bitmap, int from) {
+    for (int word = from >> 6; word < WHEEL_BITMAP_WORDS; ++word) {
+        unsigned long long bits = bitmap[word];
+        if (word == (from >> 6))
+            bits &= ~0ULL << (from & 63);
+        if (bits != 0)
+            return word * 64 + countTrailingZeros(bits);
+    }
+    return -1;
+}
+
+static bool hasAnySlot(const unsigned long long* bitmap) {
+    for (int word = 0; word < WHEEL_BITMAP_WORDS; ++word) {
+        if (bitmap[word] != 0)
+            return true;
+    }
+    return false;
+}
+
+void initTimingWheel(TimingWheel& wheel, unsigned long long startTick, int capacity) {
+    wheel.current = startTick;
+    wheel.nodes.clear();
+    wheel.nodes.reserve(capacity);
+    wheel.freeList = -1;
+    wheel.count = 0;
+    for (int level = 0; level < WHEEL_LEVELS; ++level) {
+        for (int slot = 0; slot < WHEEL_SLOTS; ++slot) {
+            wheel.slotHead[level][slot] = -1;
+            wheel.slotTail[level][slot] = -1;
+        }
+        for (int word = 0; word < WHEEL_BITMAP_WORDS; ++word)
+            wheel.occupied[level][word] = 0;
+    }
+    wheel.overflowHead = -1;
+    wheel.overflowTail = -1;
+}
+
+static int allocateNode(TimingWheel& wheel) {
+    if (wheel.freeList >= 0) {
+        int index = wheel.freeList;
+        wheel.freeList = wheel.nodes[index].next;
+        return index;
+    }
+    wheel.nodes.push_back(TimerNode());
+    wheel.nodes.back().serial = 0;
+    return (int)wheel.nodes.size() - 1;
+}
+
+static void freeNode(TimingWheel& wheel, int index) {
+    wheel.nodes[index].level = -1;
+    wheel.nodes[index].serial++;
+    wheel.nodes[index].next = wheel.freeList;
+    wheel.freeList = index;
+}
+
+// Dodaje cvor na kraj liste (pregrade ili dalekih dogadjaja), da bi redosled zakazivanja ostao ocuvan
+static void linkNode(TimingWheel& wheel, int index, int level, int slot) {
+    TimerNode& node = wheel.nodes[index];
+    node.level = (short)level;
+    node.slot = (short)slot;
+    node.next = -1;
+
+    int& head = level < WHEEL_LEVELS ? wheel.slotHead[level][slot] : wheel.overflowHead;
+    int& tail = level < WHEEL_LEVELS ? wheel.slotTail[level][slot] : wheel.overflowTail;
+    node.prev = tail;
+    if (tail >= 0)
+        wheel.nodes[tail].next = index;
+    else
+        head = index;
+    tail = index;
+
+    if (level < WHEEL_LEVELS)
+        wheel.occupied[level][slot >> 6] |= 1ULL << (slot & 63);
+}
+
+static void unlinkNode(TimingWheel& wheel, int index) {
+    TimerNode& node = wheel.nodes[index];
+    int level = node.level;
+    int slot = node.slot;
+    int& head = level < WHEEL_LEVELS ? wheel.slotHead[level][slot] : wheel.overflowHead;
+    int& tail = level < WHEEL_LEVELS ? wheel.slotTail[level][slot] : wheel.overflowTail;
+
+    if (node.prev >= 0)
+        wheel.nodes[node.prev].next = node.next;
+    else
+        head = node.next;
+    if (node.next >= 0)
+        wheel.nodes[node.next].prev = node.prev;
+    else
+        tail = node.prev;
+
+    if (level < WHEEL_LEVELS && head < 0)
+        wheel.occupied[level][slot >> 6] &= ~(1ULL << (slot & 63));
+}
+
+// Smesta cvor na nivo prema udaljenosti od tekuceg tika
+static void placeNode(TimingWheel& wheel, int index) {
+    unsigned long long tick = wheel.nodes[index].tick;
+    if (tick < wheel.current)
+        tick = wheel.current;
+    unsigned long long delta = tick - wheel.current;
+
+    int level = 0;
+    while (level < WHEEL_LEVELS && (delta >> (WHEEL_SLOT_BITS * (level + 1))) != 0)
+        level++;
+
+    int slot = level < WHEEL_LEVELS ? (int)((tick >> (WHEEL_SLOT_BITS * level)) & (WHEEL_SLOTS - 1)) : 0;
+    linkNode(wheel, index, level, slot);
+}
+
+long long scheduleTimer(TimingWheel& wheel, unsigned long long tick, unsigned long long payload) {
+    int index = allocateNode(wheel);
+    wheel.nodes[index].tick = tick;
+    wheel.nodes[index].payload = payload;
+    placeNode(wheel, index);
+    wheel.count++;
+    return ((long long)wheel.nodes[index].serial << 32) | index;
+}
+
+bool cancelTimer(TimingWheel& wheel, long long handle) {
+    if (handle < 0)
+        return false;
+    long long index = handle & 0xFFFFFFFFLL;
+    if (index >= (long long)wheel.nodes.size() || wheel.nodes[index].level < 0
+        || wheel.nodes[index].serial != (unsigned int)(handle >> 32))
+        return false;
+    unlinkNode(wheel, (int)index);
+    freeNode(wheel, (int)index);
+    wheel.count--;
+    return true;
+}
+
+// Premesta sve cvorove iz liste na nizi nivo (prema novom tekucem tiku), cuvajuci redosled
+static void redistributeList(TimingWheel& wheel, int head) {
+    while (head >= 0) {
+        int next = wheel.nodes[head].next;
+        placeNode(wheel, head);
+        head = next;
+    }
+}
+
+// Tekuci tik je na granici pregrade: spustamo pregrade visih nivoa, od najviseg ka najnizem,
+// da bi cvorovi spusteni sa viseg nivoa stigli i do nizih pregrada koje se spustaju u istom koraku
+static void cascade(TimingWheel& wheel) {
+    unsigned long long current = wheel.current;
+
+    if ((current & ((1ULL << WHEEL_RANGE_BITS) - 1)) == 0 && wheel.overflowHead >= 0) {
+        int head = wheel.overflowHead;
+        wheel.overflowHead = -1;
+        wheel.overflowTail = -1;
+        redistributeList(wheel, head);
+    }
+
+    for (int level = WHEEL_LEVELS - 1; level >= 1; --level) {
+        int shift = WHEEL_SLOT_BITS * level;
+        if ((current & ((1ULL << shift) - 1)) != 0)
+            continue;
+
+        int slot = (int)((current >> shift) & (WHEEL_SLOTS - 1));
+        int head = wheel.slotHead[level][slot];
+        if (head < 0)
+            continue;
+        wheel.slotHead[level][slot] = -1;
+        wheel.slotTail[level][slot] = -1;
+        wheel.occupied[level][slot >> 6] &= ~(1ULL << (slot & 63));
+        redistributeList(wheel, head);
+    }
+}
+
+// Prvi tik posle tekuceg kruga nivoa 0 na kome nesto mora da se desi (spustanje ili istek)
+static unsigned long long findNextBoundary(const TimingWheel& wheel) {
+    unsigned long long current = wheel.current;
+
+    // Zauzete pregrade nivoa 0 ispred tekuceg indeksa bi vec bile nadjene, pa su ostale u sledecem krugu
+    if (hasAnySlot(wheel.occupied[0]))
+        return (current | (WHEEL_SLOTS - 1)) + 1;
+
+    for (int level = 1; level < WHEEL_LEVELS; ++level) {
+        int shift = WHEEL_SLOT_BITS * level;
+        int index = (int)((current >> shift) & (WHEEL_SLOTS - 1));
+        unsigned long long revolutionStart = (current >> (shift + WHEEL_SLOT_BITS)) << (shift + WHEEL_SLOT_BITS);
+
+        int slot = findNextSlot(wheel.occupied[level], index + 1);
+        if (slot >= 0)
+            return revolutionStart | ((unsigned long long)slot << shift);
+        if (hasAnySlot(wheel.occupied[level]))
+            return revolutionStart + (1ULL << (shift + WHEEL_SLOT_BITS));
+    }
+
+    if (wheel.overflowHead >= 0)
+        return ((current >> WHEEL_RANGE_BITS) + 1) << WHEEL_RANGE_BITS;
+    return ~0ULL;
+}
+
+long long advanceTimingWheel(TimingWheel& wheel, unsigned long long targetTick, TimerCallback callback, void* user) {
+    long long expired = 0;
+
+    while (wheel.current <= targetTick) {
+        if ((wheel.current & (WHEEL_SLOTS - 1)) == 0)
+            cascade(wheel);
+
+        int index = (int)(wheel.current & (WHEEL_SLOTS - 1));
+        int slot = findNextSlot(wheel.occupied[0], index);
+        if (slot >= 0) {
+            unsigned long long slotTick = (wheel.current & ~(unsigned long long)(WHEEL_SLOTS - 1)) | slot;
+            if (slotTick > targetTick)
+                break;
+            wheel.current = slotTick;
+
+            // Skidamo jedan po jedan cvor sa pocetka pregrade, jer callback moze da zakaze nove
+            // tajmere za isti tik ili da otkaze neki koji jos ceka u ovoj pregradi
+            while (wheel.slotHead[0][slot] >= 0) {
+                int node = wheel.slotHead[0][slot];
+                unsigned long long tick = wheel.nodes[node].tick;
+                unsigned long long payload = wheel.nodes[node].payload;
+                unlinkNode(wheel, node);
+                freeNode(wheel, node);
+                wheel.count--;
+                expired++;
+                callback(user, tick, payload);
+            }
+            wheel.current = slotTick + 1;
+            continue;
+        }
+
+        // Ostatak kruga nivoa 0 je prazan: preskacemo pravo do sledeceg mesta gde ima posla
+        unsigned long long next = findNextBoundary(wheel);
+        if (next > targetTick)
+            break;
+        wheel.current = next;
+    }
+
+    if (wheel.current <= targetTick)
+        wheel.current = targetTick + 1;
+    return expired;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+
+// Hijerarhijski tocak tajmera (timing wheel) za veliki broj zakazanih dogadjaja.
+// Vreme je podeljeno na celobrojne tikove; svaki nivo ima 256 pregrada, a pregrada na nivou L
+// pokriva 256^L tikova. Dogadjaj se smesta u pregradu prema tome koliko je daleko u buducnosti,
+// a kada vreme dodje do pregrade viseg nivoa njeni dogadjaji se spustaju nivo nize (cascade).
+// Dodavanje i otkazivanje su O(1); pregrade su dvostruko povezane liste cvorova iz jednog niza,
+// a oslobodjeni cvorovi se ponovo koriste. Prazan period se preskace pomocu bitmapa zauzetih pregrada.
+// Oznaka tajmera je indeks cvora i redni broj njegove upotrebe (serial), pa oznaka tajmera koji je
+// istekao ili otkazan ne vazi ni kada se njegov cvor ponovo iskoristi.
+
+const int WHEEL_LEVELS = 4;
+const int WHEEL_SLOT_BITS = 8;
+const int WHEEL_SLOTS = 1 << WHEEL_SLOT_BITS;
+const int WHEEL_BITMAP_WORDS = WHEEL_SLOTS / 64;
+
+struct TimerNode {
+    unsigned long long tick;
+    unsigned long long payload;
+    int next;
+    int prev;
+    short level; // -1 za slobodan cvor, WHEEL_LEVELS za listu dalekih dogadjaja
+    short slot;
+    unsigned int serial; // Povecava se kad se cvor oslobodi (cvor ostaje 32 bajta)
+};
+
+struct TimingWheel {
+    unsigned long long current = 0; // Sledeci tik koji ce biti obradjen
+    std::vector<TimerNode> nodes;
+    int freeList = -1;
+    long long count = 0;
+
+    int slotHead[WHEEL_LEVELS][WHEEL_SLOTS];
+    int slotTail[WHEEL_LEVELS][WHEEL_SLOTS];
+    unsigned long long occupied[WHEEL_LEVELS][WHEEL_BITMAP_WORDS];
+
+    // Dogadjaji dalje od 256^WHEEL_LEVELS tikova; vracaju se u tocak kad se najvisi nivo okrene
+    int overflowHead = -1;
+    int overflowTail = -1;
+};
+
+// Funkcija koja se poziva za svaki istekli tajmer
+typedef void (*TimerCallback)(void* user, unsigned long long tick, unsigned long long payload);
+
+// Prazan tocak koji pocinje od tika startTick, sa mestom za capacity tajmera unapred
+void initTimingWheel(TimingWheel& wheel, unsigned long long startTick, int capacity);
+
+// Zakazuje tajmer za dati tik (tikovi u proslosti isticu pri sledecem pomeranju), vraca oznaku tajmera
+long long scheduleTimer(TimingWheel& wheel, unsigned long long tick, unsigned long long payload);
+
+// Otkazuje tajmer, vraca false ako je vec istekao ili otkazan
+bool cancelTimer(TimingWheel& wheel, long long handle);
+
+// Pomera tocak do tika targetTick (ukljucivo) i poziva callback za svaki istekli tajmer,
+// redom po tiku; tajmeri zakazani iz callback-a za tekuci tik isticu u istom pozivu.
+// Vraca broj isteklih tajmera.
+long long advanceTimingWheel(TimingWheel& wheel, unsigned long long targetTick, TimerCallback callback, void* user);
@@ -0,0 +1,16 @@
+#version 330 core
+
+layout(location = 0) in vec2 inPos;
+layout(location = 1) in vec2 inTex;
+layout(location = 2) in float inX; // Po autobusu: pozicija (iz toka instanci)
+layout(location = 3) in float inY;
+out vec2 chTex;
+
+uniform float uS; // Skaliranje (Y i X)
+uniform vec4 uRegion; // Slika autobusa u atlasu: u0, v0, u1, v1
+
+void main()
+{
+    gl_Position = vec4(inPos * uS + vec2(inX, inY), 0.0, 1.0);
+    chTex = mix(uRegion.xy, uRegion.zw, inTex);
+}
\ No newline at end of file
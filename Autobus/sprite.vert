@@ -0,0 +1,11 @@
+#version 330 core
+
+layout(location = 0) in vec2 inPos; // Vec na ekranu (NDC), upisuje ga SpriteBatch
+layout(location = 1) in vec2 inTex; // Vec u regionu atlasa
+out vec2 chTex;
+
+void main()
+{
+    gl_Position = vec4(inPos, 0.0, 1.0);
+    chTex = inTex;
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#version 330 core
+
+layout(location = 0) in vec2 inPos;
+layout(location = 1) in vec2 inTex;
+layout(location = 2) in vec4 inInstance; // Po stanici: x, y, skaliranje, sloj (slika stanice)
+out vec2 chTex;
+
+uniform vec4 uRegions[4]; // Slike stanica u atlasu, po sloju: u0, v0, u1, v1
+
+void main()
+{
+    gl_Position = vec4(inPos * inInstance.z + inInstance.xy, 0.0, 1.0);
+    vec4 region = uRegions[int(inInstance.w)];
+    chTex = mix(region.xy, region.zw, inTex);
+}
\ No newline at end of file